@@ -53,46 +53,249 @@ void NanoCanvasOps<BPP>::drawRect(const NanoRect &rect)
     drawRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y);
 }
 
+/**
+ * Cursor, writing pixels directly to canvas buffer. Position is not checked,
+ * so callers must clip coordinates against localClip() first.
+ * Coordinates are in canvas buffer terms.
+ */
 template <uint8_t BPP>
-void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+class CanvasCursor;
+
+template <>
+class CanvasCursor<1>
+{
+public:
+    CanvasCursor(uint8_t *buf, lcduint_t w, uint16_t color): m_buf(buf), m_w(w), m_set(color != 0) {}
+
+    void moveTo(lcdint_t x, lcdint_t y)
+    {
+        m_p = m_buf + static_cast<uint16_t>(y >> 3) * m_w + x;
+        m_mask = 1 << (y & 0x07);
+    }
+
+    void stepX(int8_t dir) { m_p += dir; }
+
+    void stepY(int8_t dir)
+    {
+        if (dir > 0)
+        {
+            m_mask <<= 1;
+            if (!m_mask) { m_mask = 0x01; m_p += m_w; }
+        }
+        else
+        {
+            m_mask >>= 1;
+            if (!m_mask) { m_mask = 0x80; m_p -= m_w; }
+        }
+    }
+
+    void put() { if (m_set) *m_p |= m_mask; else *m_p &= ~m_mask; }
+
+private:
+    uint8_t *m_buf;
+    lcduint_t m_w;
+    bool m_set;
+    uint8_t *m_p = nullptr;
+    uint8_t m_mask = 0;
+};
+
+template <>
+class CanvasCursor<4>
 {
-    lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
-    lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
-    lcduint_t  err = 0;
-    if (dy > dx)
+public:
+    CanvasCursor(uint8_t *buf, lcduint_t w, uint16_t color): m_buf(buf), m_w(w), m_color(color & 0x0F) {}
+
+    void moveTo(lcdint_t x, lcdint_t y)
     {
-        if (y1 > y2)
+        m_p = m_buf + static_cast<uint32_t>(y) * m_w / 2 + x / 2;
+        m_shift = (x & 1) ? 4 : 0;
+    }
+
+    void stepX(int8_t dir)
+    {
+        if (dir > 0)
+        {
+            if (m_shift) m_p++;
+        }
+        else
         {
-            canvas_swap_data(x1, x2, lcdint_t);
-            canvas_swap_data(y1, y2, lcdint_t);
+            if (!m_shift) m_p--;
         }
-        for(; y1<=y2; y1++)
+        m_shift ^= 4;
+    }
+
+    void stepY(int8_t dir) { if (dir > 0) m_p += m_w / 2; else m_p -= m_w / 2; }
+
+    void put() { *m_p = (*m_p & ~(0x0F << m_shift)) | (m_color << m_shift); }
+
+private:
+    uint8_t *m_buf;
+    lcduint_t m_w;
+    uint8_t m_color;
+    uint8_t *m_p = nullptr;
+    uint8_t m_shift = 0;
+};
+
+template <>
+class CanvasCursor<8>
+{
+public:
+    CanvasCursor(uint8_t *buf, lcduint_t w, uint16_t color): m_buf(buf), m_w(w), m_color(color) {}
+
+    void moveTo(lcdint_t x, lcdint_t y) { m_p = m_buf + static_cast<uint32_t>(y) * m_w + x; }
+
+    void stepX(int8_t dir) { m_p += dir; }
+
+    void stepY(int8_t dir) { if (dir > 0) m_p += m_w; else m_p -= m_w; }
+
+    void put() { *m_p = m_color; }
+
+private:
+    uint8_t *m_buf;
+    lcduint_t m_w;
+    uint8_t m_color;
+    uint8_t *m_p = nullptr;
+};
+
+template <>
+class CanvasCursor<16>
+{
+public:
+    CanvasCursor(uint8_t *buf, lcduint_t w, uint16_t color): m_buf(buf), m_w(w), m_color(color) {}
+
+    void moveTo(lcdint_t x, lcdint_t y) { m_p = m_buf + (static_cast<uint32_t>(y) * m_w + x) * 2; }
+
+    void stepX(int8_t dir) { m_p += 2 * dir; }
+
+    void stepY(int8_t dir) { if (dir > 0) m_p += 2 * m_w; else m_p -= 2 * m_w; }
+
+    void put() { m_p[0] = m_color >> 8; m_p[1] = m_color & 0xFF; }
+
+private:
+    uint8_t *m_buf;
+    lcduint_t m_w;
+    uint16_t m_color;
+    uint8_t *m_p = nullptr;
+};
+
+/* Products of line length and slope fit 32 bits only for 16-bit coordinates */
+#if defined(__AVR__)
+typedef int32_t canvas_long_t;
+typedef uint32_t canvas_ulong_t;
+#else
+typedef int64_t canvas_long_t;
+typedef uint64_t canvas_ulong_t;
+#endif
+
+/**
+ * Line is drawn along major axis in steps t = [0, len]. Minor coordinate at step t is
+ * m + dir * round(d * t / len). The function limits range of steps [t1, t2] to those,
+ * which have minor coordinate inside [lo, hi]. Returns false, if no steps left.
+ */
+static bool canvas_clip_line(canvas_long_t &t1, canvas_long_t &t2, lcdint_t m, int8_t dir,
+                             lcduint_t d, lcduint_t len, lcdint_t lo, lcdint_t hi)
+{
+    /* Find range of round(d * t / len) = floor((d * t + len / 2) / len) */
+    canvas_long_t kmin = dir > 0 ? (canvas_long_t)lo - m : (canvas_long_t)m - hi;
+    canvas_long_t kmax = dir > 0 ? (canvas_long_t)hi - m : (canvas_long_t)m - lo;
+    if ((kmax < 0) || (kmin > (canvas_long_t)d)) return false;
+    lcduint_t half = len >> 1;
+    if (kmin > 0)
+    {
+        t1 = max(t1, (canvas_long_t)(((canvas_ulong_t)kmin * len - half + d - 1) / d));
+    }
+    if (kmax < (canvas_long_t)d)
+    {
+        t2 = min(t2, (canvas_long_t)(((canvas_ulong_t)(kmax + 1) * len - half - 1) / d));
+    }
+    return t1 <= t2;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (x1 == x2)
+    {
+        drawVLine(x1, y1, y2);
+        return;
+    }
+    if (y1 == y2)
+    {
+        drawHLine(x1, y1, x2);
+        return;
+    }
+    x1 -= offset.x;
+    y1 -= offset.y;
+    x2 -= offset.x;
+    y2 -= offset.y;
+    lcduint_t dx = x1 > x2 ? (x1 - x2): (x2 - x1);
+    lcduint_t dy = y1 > y2 ? (y1 - y2): (y2 - y1);
+    bool steep = dy > dx;
+    /* Always draw along major axis in positive direction */
+    if (steep ? (y1 > y2) : (x1 > x2))
+    {
+        canvas_swap_data(x1, x2, lcdint_t);
+        canvas_swap_data(y1, y2, lcdint_t);
+    }
+    const NanoRect &clip = localClip();
+    lcdint_t major = steep ? y1 : x1;
+    lcdint_t minor = steep ? x1 : y1;
+    lcduint_t len = steep ? dy : dx;
+    lcduint_t d = steep ? dx : dy;
+    int8_t dir = (steep ? (x2 > x1) : (y2 > y1)) ? 1 : -1;
+    canvas_long_t t1 = max((canvas_long_t)0, (canvas_long_t)(steep ? clip.p1.y : clip.p1.x) - major);
+    canvas_long_t t2 = min((canvas_long_t)len, (canvas_long_t)(steep ? clip.p2.y : clip.p2.x) - major);
+    if ((t1 > t2) ||
+        !canvas_clip_line(t1, t2, minor, dir, d, len, steep ? clip.p1.x : clip.p1.y,
+                          steep ? clip.p2.x : clip.p2.y))
+    {
+        return;
+    }
+    /* Start Bresenham steps from the first visible pixel */
+    canvas_ulong_t acc = (canvas_ulong_t)d * t1 + (len >> 1);
+    lcduint_t err = acc % len;
+    /* err + d can overflow lcduint_t, so compare with the rest of the step instead */
+    lcduint_t rest = len - d;
+    major += t1;
+    minor += dir * (lcdint_t)(acc / len);
+    CanvasCursor<BPP> cursor(m_buf, m_w, m_color);
+    lcduint_t count = t2 - t1;
+    if (steep)
+    {
+        cursor.moveTo(minor, major);
+        for (;;)
         {
-            err += dx;
-            if (err >= dy)
+            cursor.put();
+            if (!count--) break;
+            if (err >= rest)
+            {
+                err -= rest;
+                cursor.stepX(dir);
+            }
+            else
             {
-                 err -= dy;
-                 x1 < x2 ? x1++: x1--;
+                err += d;
             }
-            putPixel( x1, y1 );
+            cursor.stepY(1);
         }
     }
     else
     {
-        if (x1 > x2)
+        cursor.moveTo(major, minor);
+        for (;;)
         {
-            canvas_swap_data(x1, x2, lcdint_t);
-            canvas_swap_data(y1, y2, lcdint_t);
-        }
-        for(; x1<=x2; x1++)
-        {
-            err += dy;
-            if (err >= dx)
+            cursor.put();
+            if (!count--) break;
+            if (err >= rest)
+            {
+                err -= rest;
+                cursor.stepY(dir);
+            }
+            else
             {
-                 err -= dx;
-                 if (y1 < y2) y1++; else y1--;
+                err += d;
             }
-            putPixel( x1, y1 );
+            cursor.stepX(1);
         }
     }
 }
@@ -112,19 +315,39 @@ void NanoCanvasOps<BPP>::fillRect(const NanoRect &rect)
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::drawCircle(lcdint_t xc, lcdint_t yc, lcdint_t r)
 {
-    if ((xc + r < offset.x) || (yc + r < offset.y) ||
-        (xc - r >= (lcdint_t)m_w + offset.x) || (yc - r >= (lcdint_t)m_h - offset.y))
+    if (r <= 0)
     {
+        if (r == 0) putPixel(xc, yc);
         return;
     }
-    lcdint_t d = 3 - 2 * r;
+    xc -= offset.x;
+    yc -= offset.y;
+    const NanoRect &clip = localClip();
+    if ((xc + r < clip.p1.x) || (yc + r < clip.p1.y) ||
+        (xc - r > clip.p2.x) || (yc - r > clip.p2.y))
+    {
+        return;
+    }
+    /* Most circles are entirely visible, so check pixels only for partially visible ones */
+    bool inside = (xc - r >= clip.p1.x) && (yc - r >= clip.p1.y) &&
+                  (xc + r <= clip.p2.x) && (yc + r <= clip.p2.y);
+    CanvasCursor<BPP> cursor(m_buf, m_w, m_color);
+    auto plot = [&](lcdint_t x, lcdint_t y)
+    {
+        if (inside || ((x >= clip.p1.x) && (y >= clip.p1.y) && (x <= clip.p2.x) && (y <= clip.p2.y)))
+        {
+            cursor.moveTo(x, y);
+            cursor.put();
+        }
+    };
+    int d = 3 - 2 * r;
     lcdint_t x = 0;
     lcdint_t y = r;
 
-    putPixel(xc, yc + r);
-    putPixel(xc, yc - r);
-    putPixel(xc + r, yc);
-    putPixel(xc - r, yc);
+    plot(xc, yc + r);
+    plot(xc, yc - r);
+    plot(xc + r, yc);
+    plot(xc - r, yc);
     while (y >= x)
     {
         x++;
@@ -135,14 +358,218 @@ void NanoCanvasOps<BPP>::drawCircle(lcdint_t xc, lcdint_t yc, lcdint_t r)
         }
         d += 4 * x + 6;
 
-        putPixel(xc+x, yc+y);
-        putPixel(xc-x, yc+y);
-        putPixel(xc+x, yc-y);
-        putPixel(xc-x, yc-y);
-        putPixel(xc+y, yc+x);
-        putPixel(xc-y, yc+x);
-        putPixel(xc+y, yc-x);
-        putPixel(xc-y, yc-x);
+        plot(xc+x, yc+y);
+        plot(xc-x, yc+y);
+        plot(xc+x, yc-y);
+        plot(xc-x, yc-y);
+        plot(xc+y, yc+x);
+        plot(xc-y, yc+x);
+        plot(xc+y, yc-x);
+        plot(xc-y, yc-x);
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillRoundArea(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t r)
+{
+    /* Same steps as drawCircle(), but each row is filled at once, when its width is known */
+    int d = 3 - 2 * r;
+    lcdint_t x = 0;
+    lcdint_t y = r;
+
+    fillRect(x1 - r, y1, x2 + r, y2);
+    while (y >= x)
+    {
+        x++;
+        if (d > 0)
+        {
+            drawHLine(x1 - x + 1, y1 - y, x2 + x - 1);
+            drawHLine(x1 - x + 1, y2 + y, x2 + x - 1);
+            y--;
+            d += - 4 * y + 4;
+        }
+        d += 4 * x + 6;
+        drawHLine(x1 - y, y1 - x, x2 + y);
+        drawHLine(x1 - y, y2 + x, x2 + y);
+    }
+    drawHLine(x1 - x, y1 - y, x2 + x);
+    drawHLine(x1 - x, y2 + y, x2 + x);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillCircle(lcdint_t xc, lcdint_t yc, lcdint_t r)
+{
+    const NanoRect clip = clipRect();
+    if ((r < 0) ||
+        (xc + r < clip.p1.x) || (yc + r < clip.p1.y) ||
+        (xc - r > clip.p2.x) || (yc - r > clip.p2.y))
+    {
+        return;
+    }
+    if (r == 0)
+    {
+        putPixel(xc, yc);
+        return;
+    }
+    fillRoundArea(xc, yc, xc, yc, r);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t r)
+{
+    if (x2 < x1) canvas_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) canvas_swap_data(y2, y1, lcdint_t);
+    r = min(r, (lcdint_t)(min(x2 - x1, y2 - y1) / 2));
+    if (r <= 0)
+    {
+        fillRect(x1, y1, x2, y2);
+        return;
+    }
+    fillRoundArea(x1 + r, y1 + r, x2 - r, y2 - r, r);
+}
+
+/**
+ * Polygon edge, walked from top to bottom row by row.
+ * X position is rounded to the nearest pixel.
+ */
+typedef struct
+{
+    lcdint_t x;     ///< position of the edge in current row
+    lcdint_t step;  ///< integer part of x increment per row
+    int8_t dir;     ///< direction of x increment
+    lcduint_t num;  ///< fractional part of x increment per row, multiplied by den
+    lcduint_t den;  ///< height of the edge
+    lcduint_t err;  ///< accumulated fractional part of x position
+} CanvasEdge;
+
+/**
+ * Initializes edge from (x1,y1) to (x2,y2), y1 < y2, at row y.
+ */
+static void canvas_edge_init(CanvasEdge &edge, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t y)
+{
+    lcduint_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    edge.dir = x2 < x1 ? -1 : 1;
+    edge.den = y2 - y1;
+    edge.step = edge.dir * (lcdint_t)(dx / edge.den);
+    edge.num = dx % edge.den;
+    canvas_ulong_t acc = (canvas_ulong_t)dx * (lcduint_t)(y - y1) + (edge.den >> 1);
+    edge.x = x1 + edge.dir * (lcdint_t)(acc / edge.den);
+    edge.err = acc % edge.den;
+}
+
+static inline void canvas_edge_next(CanvasEdge &edge)
+{
+    edge.x += edge.step;
+    /* err + num can overflow lcduint_t, so compare with the rest of the step instead */
+    if (edge.err >= edge.den - edge.num)
+    {
+        edge.err -= edge.den - edge.num;
+        edge.x += edge.dir;
+    }
+    else
+    {
+        edge.err += edge.num;
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2,
+                                      lcdint_t x3, lcdint_t y3)
+{
+    /* Sort vertices from top to bottom */
+    if (y2 < y1) { canvas_swap_data(x1, x2, lcdint_t); canvas_swap_data(y1, y2, lcdint_t); }
+    if (y3 < y2) { canvas_swap_data(x2, x3, lcdint_t); canvas_swap_data(y2, y3, lcdint_t); }
+    if (y2 < y1) { canvas_swap_data(x1, x2, lcdint_t); canvas_swap_data(y1, y2, lcdint_t); }
+    const NanoRect clip = clipRect();
+    if ((y3 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    if (y1 == y3)
+    {
+        drawHLine(min(x1, min(x2, x3)), y1, max(x1, max(x2, x3)));
+        return;
+    }
+    lcdint_t y = max(y1, clip.p1.y);
+    lcdint_t yend = min(y3, clip.p2.y);
+    /* Upper part is drawn from the long and the top edge, lower part uses the bottom edge.
+       Flat bottom row belongs to upper part, since the bottom edge is horizontal */
+    lcdint_t ylast = y2 == y3 ? y3 : y2 - 1;
+    CanvasEdge a, b;
+    canvas_edge_init(a, x1, y1, x3, y3, y);
+    if (y <= ylast)
+    {
+        canvas_edge_init(b, x1, y1, x2, y2, y);
+        for (; y <= min(ylast, yend); y++)
+        {
+            drawHLine(a.x, y, b.x);
+            canvas_edge_next(a);
+            canvas_edge_next(b);
+        }
+    }
+    if (y <= yend)
+    {
+        canvas_edge_init(b, x2, y2, x3, y3, y);
+        for (; y <= yend; y++)
+        {
+            drawHLine(a.x, y, b.x);
+            canvas_edge_next(a);
+            canvas_edge_next(b);
+        }
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillPolygon(const NanoPoint *points, uint8_t count)
+{
+    if ((count == 0) || (count > CANVAS_POLYGON_MAX_POINTS)) return;
+    NanoRect bounds = { points[0], points[0] };
+    for (uint8_t i = 1; i < count; i++)
+    {
+        bounds.p1.x = min(bounds.p1.x, points[i].x);
+        bounds.p1.y = min(bounds.p1.y, points[i].y);
+        bounds.p2.x = max(bounds.p2.x, points[i].x);
+        bounds.p2.y = max(bounds.p2.y, points[i].y);
+    }
+    const NanoRect clip = clipRect();
+    if ((bounds.p2.x < clip.p1.x) || (bounds.p2.y < clip.p1.y) ||
+        (bounds.p1.x > clip.p2.x) || (bounds.p1.y > clip.p2.y))
+    {
+        return;
+    }
+    if (bounds.p1.y == bounds.p2.y)
+    {
+        drawHLine(bounds.p1.x, bounds.p1.y, bounds.p2.x);
+        return;
+    }
+    lcdint_t nodes[CANVAS_POLYGON_MAX_POINTS];
+    lcdint_t yend = min(bounds.p2.y, clip.p2.y);
+    for (lcdint_t y = max(bounds.p1.y, clip.p1.y); y <= yend; y++)
+    {
+        uint8_t n = 0;
+        const NanoPoint *prev = &points[count - 1];
+        for (uint8_t i = 0; i < count; prev = &points[i++])
+        {
+            const NanoPoint *top = prev->y < points[i].y ? prev : &points[i];
+            const NanoPoint *bottom = prev->y < points[i].y ? &points[i] : prev;
+            /* Edges are half-open to count each crossing once, except for the bottom row */
+            if ((top->y == bottom->y) || (y < top->y) || (y > bottom->y) ||
+                ((y == bottom->y) && (y != bounds.p2.y)))
+            {
+                continue;
+            }
+            CanvasEdge edge;
+            canvas_edge_init(edge, top->x, top->y, bottom->x, bottom->y, y);
+            /* Insertion sort: there are few crossings per row */
+            uint8_t j = n++;
+            while (j > 0 && nodes[j - 1] > edge.x)
+            {
+                nodes[j] = nodes[j - 1];
+                j--;
+            }
+            nodes[j] = edge.x;
+        }
+        for (uint8_t i = 1; i < n; i += 2)
+        {
+            drawHLine(nodes[i - 1], y, nodes[i]);
+        }
     }
 }
 
@@ -245,8 +672,9 @@ void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x<0) || (y<0)) return;
-    if (( x >= (lcdint_t)m_w ) || ( y >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if ((x < clip.p1.x) || (y < clip.p1.y)) return;
+    if ((x > clip.p2.x) || (y > clip.p2.y)) return;
     if (m_color)
     {
         m_buf[YADDR1(y) + x] |= (1 << (y & 0x7));
@@ -257,6 +685,52 @@ void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
     }
 }
 
+/**
+ * Sets (or clears) bits of mask in count bytes of single bank. Full banks are
+ * filled via memset, partial banks are processed by machine words.
+ */
+static void canvas_fill_bank1(uint8_t *dst, lcduint_t count, uint8_t mask, bool set)
+{
+    if (mask == 0xFF)
+    {
+        memset(dst, set ? 0xFF : 0x00, count);
+        return;
+    }
+    if (!set)
+    {
+        mask = ~mask;
+    }
+    while (count && ((uintptr_t)dst & (sizeof(uintptr_t) - 1)))
+    {
+        if (set) *dst |= mask; else *dst &= mask;
+        dst++;
+        count--;
+    }
+    uintptr_t pattern = (uintptr_t)(~(uintptr_t)0) / 0xFF * mask;
+    if (set)
+    {
+        for (; count >= sizeof(uintptr_t); count -= sizeof(uintptr_t), dst += sizeof(uintptr_t))
+        {
+            uintptr_t word;
+            memcpy(&word, dst, sizeof(word));
+            word |= pattern;
+            memcpy(dst, &word, sizeof(word));
+        }
+        while (count--) *dst++ |= mask;
+    }
+    else
+    {
+        for (; count >= sizeof(uintptr_t); count -= sizeof(uintptr_t), dst += sizeof(uintptr_t))
+        {
+            uintptr_t word;
+            memcpy(&word, dst, sizeof(word));
+            word &= pattern;
+            memcpy(dst, &word, sizeof(word));
+        }
+        while (count--) *dst++ &= mask;
+    }
+}
+
 template <>
 void NanoCanvasOps<1>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
@@ -264,20 +738,12 @@ void NanoCanvasOps<1>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     x1 -= offset.x;
     x2 -= offset.x;
     y1 -= offset.y;
-    if ((y1 >= (lcdint_t)m_h) || (y1 < 0)) return;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    x1 = max(0, x1);
-    x2 = min(x2, (lcdint_t)(m_w -1));
-    uint16_t addr = YADDR1(y1) + x1;
-    uint8_t mask = (1 << (y1 & 0x7));
-    if (m_color)
-    {
-        do { m_buf[addr++] |= mask; } while (x2>x1++);
-    }
-    else
-    {
-        do { m_buf[addr++] &= ~mask; } while (x2>x1++);
-    }
+    const NanoRect &clip = localClip();
+    if ((y1 > clip.p2.y) || (y1 < clip.p1.y)) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
+    canvas_fill_bank1(&m_buf[YADDR1(y1) + x1], x2 - x1 + 1, (1 << (y1 & 0x7)), m_color != 0);
 }
 
 template <>
@@ -287,10 +753,11 @@ void NanoCanvasOps<1>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
-    if ((x1 >= (lcdint_t)m_w) || (x1 < 0)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(0, y1);
-    y2 = min(y2, (lcdint_t)(m_h -1));
+    const NanoRect &clip = localClip();
+    if ((x1 > clip.p2.x) || (x1 < clip.p1.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    y1 = max(y1, clip.p1.y);
+    y2 = min(y2, clip.p2.y);
 
     uint16_t addr = YADDR1(y1) + x1;
     if ((y1 & 0xFFF8) == (y2 & 0xFFF8))
@@ -335,41 +802,40 @@ void NanoCanvasOps<1>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     x2 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(0, x1);
-    x2 = min(x2, (lcdint_t)(m_w - 1));
-    y1 = max(0, y1);
-    y2 = min(y2, (lcdint_t)(m_h - 1));
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
+    y1 = max(y1, clip.p1.y);
+    y2 = min(y2, clip.p2.y);
     uint8_t bank1 = (y1 >> 3);
     uint8_t bank2 = (y2 >> 3);
-    for (uint8_t bank = bank1; bank<=bank2; bank++)
+    lcduint_t count = x2 - x1 + 1;
+    bool set = m_color != 0;
+    uint8_t *dst = &m_buf[BANK_ADDR1(bank1) + x1];
+    if (bank1 == bank2)
     {
-        uint8_t mask = 0xFF;
-        if (bank1 == bank2)
-        {
-            mask = (mask >> ((y1 & 7) + 7 - (y2 & 7))) << (y1 & 7);
-        }
-        else if (bank1 == bank)
-        {
-            mask = (mask << (y1 & 7));
-        }
-        else if (bank2 == bank)
-        {
-            mask = (mask >> (7 - (y2 & 7)));
-        }
-        for (uint8_t x=x1; x<=x2; x++)
+        canvas_fill_bank1(dst, count, (0xFF >> ((y1 & 7) + 7 - (y2 & 7))) << (y1 & 7), set);
+        return;
+    }
+    canvas_fill_bank1(dst, count, 0xFF << (y1 & 7), set);
+    if (count == m_w)
+    {
+        /* Full width rectangle: middle banks are contiguous in the buffer */
+        memset(dst + m_w, set ? 0xFF : 0x00, (uint16_t)(bank2 - bank1 - 1) * m_w);
+        dst += (uint16_t)(bank2 - bank1 - 1) * m_w;
+    }
+    else
+    {
+        for (uint8_t bank = bank1 + 1; bank < bank2; bank++)
         {
-            if (m_color)
-            {
-                m_buf[BANK_ADDR1(bank) + x] |= mask;
-            }
-            else
-            {
-                m_buf[BANK_ADDR1(bank) + x] &= ~mask;
-            }
+            dst += m_w;
+            canvas_fill_bank1(dst, count, 0xFF, set);
         }
     }
+    canvas_fill_bank1(dst + m_w, count, 0xFF >> (7 - (y2 & 7)), set);
 };
 
 template <>
@@ -378,7 +844,82 @@ void NanoCanvasOps<1>::clear()
     memset(m_buf, 0, YADDR1(m_h));
 }
 
-// TODO: Not so fast implementation. needs to be optimized
+/** Raster operations of 1-bit bitmap blitter */
+enum
+{
+    CANVAS_BLIT1_OPAQUE,
+    CANVAS_BLIT1_OPAQUE_INVERSE,
+    CANVAS_BLIT1_SET,
+    CANVAS_BLIT1_CLEAR,
+};
+
+template <uint8_t OP>
+static inline void canvas_blit_byte1(uint8_t &dst, uint8_t data, uint8_t mask)
+{
+    switch (OP)
+    {
+        case CANVAS_BLIT1_OPAQUE: dst = (dst & ~mask) | (data & mask); break;
+        case CANVAS_BLIT1_OPAQUE_INVERSE: dst = (dst & ~mask) | (~data & mask); break;
+        case CANVAS_BLIT1_SET: dst |= data & mask; break;
+        default: dst &= ~(data & mask); break;
+    }
+}
+
+/**
+ * Merges w columns of single display page, processing 4 columns per iteration.
+ * fetch(i) returns bitmap data for column i, already shifted to page position.
+ */
+template <uint8_t OP, class F>
+static inline void canvas_blit_columns1(uint8_t *dst, lcduint_t w, uint8_t mask, F fetch)
+{
+    lcduint_t i = 0;
+    for (; i + 4 <= w; i += 4)
+    {
+        canvas_blit_byte1<OP>(dst[i], fetch(i), mask);
+        canvas_blit_byte1<OP>(dst[i + 1], fetch(i + 1), mask);
+        canvas_blit_byte1<OP>(dst[i + 2], fetch(i + 2), mask);
+        canvas_blit_byte1<OP>(dst[i + 3], fetch(i + 3), mask);
+    }
+    for (; i < w; i++)
+    {
+        canvas_blit_byte1<OP>(dst[i], fetch(i), mask);
+    }
+}
+
+/**
+ * Draws page of 1-bit bitmap. If bitmap is not aligned to display pages,
+ * display page is built from lower part of current bitmap page (main) and
+ * upper part of previous bitmap page (complex), located stride bytes before.
+ * Only bits, set in clip mask, are changed.
+ */
+template <uint8_t OP>
+static void canvas_blit_page1(uint8_t *dst, const uint8_t *bitmap, lcduint_t w, lcduint_t stride,
+                              uint8_t offs, bool main, bool complex, uint8_t clip)
+{
+    if (!offs)
+    {
+        canvas_blit_columns1<OP>(dst, w, clip, [bitmap](lcduint_t i) -> uint8_t
+            { return pgm_read_byte(&bitmap[i]); });
+    }
+    else if (main && complex)
+    {
+        const uint8_t *prev = bitmap - stride;
+        canvas_blit_columns1<OP>(dst, w, clip, [bitmap, prev, offs](lcduint_t i) -> uint8_t
+            { return (pgm_read_byte(&bitmap[i]) << offs) | (pgm_read_byte(&prev[i]) >> (8 - offs)); });
+    }
+    else if (main)
+    {
+        canvas_blit_columns1<OP>(dst, w, (0xFF << offs) & clip, [bitmap, offs](lcduint_t i) -> uint8_t
+            { return pgm_read_byte(&bitmap[i]) << offs; });
+    }
+    else if (complex)
+    {
+        const uint8_t *prev = bitmap - stride;
+        canvas_blit_columns1<OP>(dst, w, (0xFF >> (8 - offs)) & clip, [prev, offs](lcduint_t i) -> uint8_t
+            { return pgm_read_byte(&prev[i]) >> (8 - offs); });
+    }
+}
+
 template <>
 void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
@@ -386,65 +927,64 @@ void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_
     y -= offset.y;
     lcduint_t origin_width = w;
     uint8_t offs = y & 0x07;
-    uint8_t complexFlag = 0;
-    uint8_t mainFlag = 1;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    bool complexFlag = false;
+    bool mainFlag = true;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if (y + (lcdint_t)h <= clip.p1.y) return;
+    if (y > clip.p2.y) return;
+    if (x + (lcdint_t)w <= clip.p1.x) return;
+    if (x > clip.p2.x)  return;
     if (y < 0)
     {
          bitmap += ((lcduint_t)((-y) + 7) >> 3) * w;
          h += y;
          y = 0;
-         complexFlag = 1;
+         complexFlag = true;
     }
-    if (x < 0)
+    if (x < clip.p1.x)
     {
-         bitmap += -x;
-         w += x;
-         x = 0;
+         bitmap += clip.p1.x - x;
+         w -= clip.p1.x - x;
+         x = clip.p1.x;
     }
     uint8_t max_pages = (lcduint_t)(h + 15 - offs) >> 3;
     if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
     {
          h = (lcduint_t)(m_h - (lcduint_t)y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w - 1 > clip.p2.x)
     {
-         w = (lcduint_t)(m_w - (lcduint_t)x);
+         w = (lcduint_t)(clip.p2.x - x + 1);
     }
     uint8_t pages = ((y + h - 1) >> 3) - (y >> 3) + 1;
-    uint8_t j;
-    lcduint_t i;
-
-    for(j=0; j < pages; j++)
+    void (*blit)(uint8_t *, const uint8_t *, lcduint_t, lcduint_t, uint8_t, bool, bool, uint8_t);
+    if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+    {
+        blit = m_color == BLACK ? canvas_blit_page1<CANVAS_BLIT1_OPAQUE_INVERSE>
+                                : canvas_blit_page1<CANVAS_BLIT1_OPAQUE>;
+    }
+    else
+    {
+        blit = m_color == BLACK ? canvas_blit_page1<CANVAS_BLIT1_CLEAR>
+                                : canvas_blit_page1<CANVAS_BLIT1_SET>;
+    }
+    uint8_t *dst = &m_buf[YADDR1(y) + x];
+    lcdint_t top = y & ~0x07;
+    for(uint8_t j=0; j < pages; j++, top += 8)
     {
-        uint16_t addr = YADDR1(y + ((uint16_t)j<<3)) + x;
         if ( j == max_pages - 1 ) mainFlag = !offs;
-        for( i=w; i > 0; i--)
+        /* Pages, partially covered by clip area, are drawn with mask */
+        if ( (clip.p1.y < top + 8) && (clip.p2.y >= top) )
         {
-            uint8_t data = 0;
-            uint8_t mask = 0;
-            if ( mainFlag )    { data |= (pgm_read_byte(bitmap) << offs); mask |= (0xFF << offs); }
-            if ( complexFlag ) { data |= (pgm_read_byte(bitmap - origin_width) >> (8 - offs)); mask |= (0xFF >> (8 - offs)); }
-            if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
-            {
-                m_buf[addr] &= ~mask;
-                m_buf[addr] |= m_color == BLACK ? ~data: data;
-            }
-            else
-            {
-                if (m_color == BLACK)
-                    m_buf[addr] &= ~data;
-                else
-                    m_buf[addr] |= data;
-            }
-            bitmap++;
-            addr++;
+            uint8_t clipMask = 0xFF;
+            if ( clip.p1.y > top ) clipMask <<= (clip.p1.y - top);
+            if ( clip.p2.y < top + 7 ) clipMask &= 0xFF >> (top + 7 - clip.p2.y);
+            blit(dst, bitmap, w, origin_width, offs, mainFlag, complexFlag, clipMask);
         }
-        bitmap += origin_width - w;
-        complexFlag = offs;
+        bitmap += origin_width;
+        dst += m_w;
+        complexFlag = offs != 0;
     }
 }
 
@@ -455,6 +995,8 @@ void NanoCanvasOps<1>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clipDepth = 0;
+    updateClip();
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = WHITE;
@@ -480,7 +1022,8 @@ void NanoCanvasOps<4>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    const NanoRect &clip = localClip();
+    if ((x >= clip.p1.x) && (y >= clip.p1.y) && (x <= clip.p2.x) && (y <= clip.p2.y))
     {
         m_buf[YADDR4(y) + x / 2] &= ~(0x0F << BITS_SHIFT4(x));
         m_buf[YADDR4(y) + x / 2] |= (m_color & 0x0F) << BITS_SHIFT4(x);
@@ -497,10 +1040,11 @@ void NanoCanvasOps<4>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         canvas_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    const NanoRect &clip = localClip();
+    if ((x1 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    y1 = max(y1, clip.p1.y);
+    y2 = min(y2, clip.p2.y) - y1;
     uint8_t *buf = m_buf + YADDR4(y1) + x1 / 2;
     do
     {
@@ -511,6 +1055,31 @@ void NanoCanvasOps<4>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     while (y2--);
 }
 
+/**
+ * Fills pixels [x1, x2] of single row with color. Pairs of pixels
+ * are filled via memset, only odd edges are processed by nibbles.
+ */
+static void canvas_fill_row4(uint8_t *row, lcdint_t x1, lcdint_t x2, uint8_t color)
+{
+    uint8_t *buf = row + x1 / 2;
+    if (x1 & 1)
+    {
+        *buf = (*buf & 0x0F) | (color << 4);
+        buf++;
+        x1++;
+    }
+    if (x1 > x2)
+    {
+        return;
+    }
+    lcduint_t count = (lcduint_t)(x2 - x1 + 1) / 2;
+    memset(buf, color | (color << 4), count);
+    if (!(x2 & 1))
+    {
+        buf[count] = (buf[count] & 0xF0) | color;
+    }
+}
+
 template <>
 void NanoCanvasOps<4>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
@@ -521,20 +1090,12 @@ void NanoCanvasOps<4>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         canvas_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    uint8_t *buf = m_buf + YADDR4(y1) + x1 / 2;
-    for (lcdint_t x = x1; x <= x2; x++)
-    {
-        *buf &= ~(0x0F << BITS_SHIFT4(x));
-        *buf |= ((m_color & 0x0F) << BITS_SHIFT4(x));
-        if ( x & 1 )
-        {
-            buf++;
-        }
-    }
+    const NanoRect &clip = localClip();
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y1 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
+    canvas_fill_row4(m_buf + YADDR4(y1), x1, x2, m_color & 0x0F);
 }
 
 template <>
@@ -552,25 +1113,17 @@ void NanoCanvasOps<4>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
-    uint8_t *buf = m_buf + YADDR4(y1) + x1 / 2;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
+    y1 = max(y1, clip.p1.y);
+    y2 = min(y2, clip.p2.y);
     for (lcdint_t y = y1; y <= y2; y++)
     {
-        for (lcdint_t x = x1; x <= x2; x++)
-        {
-            *buf &= ~(0x0F << BITS_SHIFT4(x));
-            *buf |= ((m_color & 0xF) << BITS_SHIFT4(x));
-            if ( x & 1 )
-            {
-                buf++;
-            }
-        }
-        buf += ((lcdint_t)(m_w) - (x2 - x1 + ((x2 - x1) & 0x1))) / 2;
+        canvas_fill_row4(m_buf + YADDR4(y), x1, x2, m_color & 0x0F);
     }
 }
 
@@ -587,28 +1140,28 @@ void NanoCanvasOps<4>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + xb2;
     lcdint_t y2 = y1 + yb2;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < clip.p1.x)
     {
-        xb1 -= x1;
-        x1 = 0;
+        xb1 += clip.p1.x - x1;
+        x1 = clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < clip.p1.y)
     {
-        yb1 -= y1;
-        y1 = 0;
+        yb1 += clip.p1.y - y1;
+        y1 = clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > clip.p2.y)
     {
-//         yb2 -= (y2 - (lcdint_t)m_h + 1);
-         y2 = (lcdint_t)m_h - 1;
+         y2 = clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > clip.p2.x)
     {
-//         xb2 -= (x2 - (lcdint_t)m_w + 1);
-         x2 = (lcdint_t)m_w - 1;
+         x2 = clip.p2.x;
     }
     for ( lcdint_t y = y1; y <= y2; y++ )
     {
@@ -646,28 +1199,28 @@ void NanoCanvasOps<4>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + xb2;
     lcdint_t y2 = y1 + yb2;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < clip.p1.x)
     {
-        xb1 -= x1;
-        x1 = 0;
+        xb1 += clip.p1.x - x1;
+        x1 = clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < clip.p1.y)
     {
-        yb1 -= y1;
-        y1 = 0;
+        yb1 += clip.p1.y - y1;
+        y1 = clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > clip.p2.y)
     {
-//         yb2 -= (y2 - (lcdint_t)m_h + 1);
-         y2 = (lcdint_t)m_h - 1;
+         y2 = clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > clip.p2.x)
     {
-//         xb2 -= (x2 - (lcdint_t)m_w + 1);
-         x2 = (lcdint_t)m_w - 1;
+         x2 = clip.p2.x;
     }
     for ( lcdint_t y = y1; y <= y2; y++ )
     {
@@ -700,6 +1253,8 @@ void NanoCanvasOps<4>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clipDepth = 0;
+    updateClip();
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = 0xFF; // white color by default
@@ -724,7 +1279,8 @@ void NanoCanvasOps<8>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    const NanoRect &clip = localClip();
+    if ((x >= clip.p1.x) && (y >= clip.p1.y) && (x <= clip.p2.x) && (y <= clip.p2.y))
     {
         m_buf[YADDR8(y) + x] = m_color;
     }
@@ -740,11 +1296,12 @@ void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         canvas_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
+    const NanoRect &clip = localClip();
+    if ((x1 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    y1 = max(y1, clip.p1.y);
     uint8_t *buf = m_buf + YADDR8(y1) + x1;
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    y2 = min(y2, clip.p2.y) - y1;
     do
     {
         *buf = m_color;
@@ -763,10 +1320,11 @@ void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         canvas_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
+    const NanoRect &clip = localClip();
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y1 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
     uint8_t *buf = m_buf + YADDR8(y1) + x1;
     for (lcdint_t x = 0; x <= x2 - x1; x++)
     {
@@ -790,12 +1348,14 @@ void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
+    y1 = max(y1, clip.p1.y);
+    y2 = min(y2, clip.p2.y);
     uint8_t *buf = m_buf + YADDR8(y1) + x1;
     for (lcdint_t y = y1; y <= y2; y++)
     {
@@ -818,27 +1378,29 @@ void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += clip.p1.x - x1;
+        x1 = clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < clip.p1.y)
     {
-        bitmap += ((lcduint_t)(-y1) >> 3) * w;
-        offs = ((-y1) & 0x07);
-        y1 = 0;
+        bitmap += ((lcduint_t)(clip.p1.y - y1) >> 3) * w;
+        offs = ((clip.p1.y - y1) & 0x07);
+        y1 = clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = clip.p2.x;
     }
     uint8_t offs2 = 8 - offs;
     lcdint_t y = y1;
@@ -874,26 +1436,28 @@ void NanoCanvasOps<8>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += clip.p1.x - x1;
+        x1 = clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < clip.p1.y)
     {
-        bitmap += (lcduint_t)(-y1) * w;
-        y1 = 0;
+        bitmap += (lcduint_t)(clip.p1.y - y1) * w;
+        y1 = clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = clip.p2.x;
     }
     lcdint_t y = y1;
     while ( y <= y2 )
@@ -926,6 +1490,8 @@ void NanoCanvasOps<8>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clipDepth = 0;
+    updateClip();
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = 0xFF; // white color by default
@@ -950,7 +1516,8 @@ void NanoCanvasOps<16>::putPixel(lcdint_t x, lcdint_t y)
 {
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    const NanoRect &clip = localClip();
+    if ((x >= clip.p1.x) && (y >= clip.p1.y) && (x <= clip.p2.x) && (y <= clip.p2.y))
     {
         m_buf[YADDR16(y) + (x<<1)] = m_color >> 8;
         m_buf[YADDR16(y) + (x<<1) + 1] = m_color & 0xFF;
@@ -967,11 +1534,12 @@ void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         canvas_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
+    const NanoRect &clip = localClip();
+    if ((x1 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    y1 = max(y1, clip.p1.y);
     uint8_t *buf = m_buf + YADDR16(y1) + (x1 << 1);
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    y2 = min(y2, clip.p2.y) - y1;
     do
     {
         buf[0] = m_color >> 8;
@@ -991,10 +1559,11 @@ void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         canvas_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
+    const NanoRect &clip = localClip();
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y1 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
     uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
     for (lcdint_t x = 0; x <= x2 - x1; x++)
     {
@@ -1019,12 +1588,14 @@ void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
+    x1 = max(x1, clip.p1.x);
+    x2 = min(x2, clip.p2.x);
+    y1 = max(y1, clip.p1.y);
+    y2 = min(y2, clip.p2.y);
     uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
     for (lcdint_t y = y1; y <= y2; y++)
     {
@@ -1048,27 +1619,29 @@ void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += clip.p1.x - x1;
+        x1 = clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < clip.p1.y)
     {
-        bitmap += ((lcduint_t)(-y1) >> 3) * w;
-        offs = ((-y1) & 0x07);
-        y1 = 0;
+        bitmap += ((lcduint_t)(clip.p1.y - y1) >> 3) * w;
+        offs = ((clip.p1.y - y1) & 0x07);
+        y1 = clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = clip.p2.x;
     }
     uint8_t offs2 = 8 - offs;
     lcdint_t y = y1;
@@ -1110,26 +1683,28 @@ void NanoCanvasOps<16>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    const NanoRect &clip = localClip();
+    if (clip.p2.x < clip.p1.x) return;
+    if ((x2 < clip.p1.x) || (x1 > clip.p2.x)) return;
+    if ((y2 < clip.p1.y) || (y1 > clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += clip.p1.x - x1;
+        x1 = clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < clip.p1.y)
     {
-        bitmap += (lcduint_t)(-y1) * w;
-        y1 = 0;
+        bitmap += (lcduint_t)(clip.p1.y - y1) * w;
+        y1 = clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = clip.p2.x;
     }
     lcdint_t y = y1;
     while ( y <= y2 )
@@ -1164,6 +1739,8 @@ void NanoCanvasOps<16>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_h = h;
     offset.x = 0;
     offset.y = 0;
+    m_clipDepth = 0;
+    updateClip();
     m_cursorX = 0;
     m_cursorY = 0;
     m_color = 0xFFFF; // white color by default
@@ -39,6 +39,24 @@
  * @{
  */
 
+#if defined(__AVR__)
+
+#ifndef CANVAS_CLIP_STACK_DEPTH
+#define CANVAS_CLIP_STACK_DEPTH  1   ///< Maximum number of nested clip rectangles. Can be defined outside the library
+#endif
+
+#else
+
+#ifndef CANVAS_CLIP_STACK_DEPTH
+#define CANVAS_CLIP_STACK_DEPTH  4   ///< Maximum number of nested clip rectangles. Can be defined outside the library
+#endif
+
+#endif
+
+#ifndef CANVAS_POLYGON_MAX_POINTS
+#define CANVAS_POLYGON_MAX_POINTS 16 ///< Maximum number of polygon vertices for fillPolygon(). Can be defined outside the library
+#endif
+
 /**
  * NanoCanvasOps provides operations for drawing in memory buffer.
  * Depending on BPP argument, this class can work with 1,8,16-bit canvas areas.
@@ -52,7 +70,9 @@ public:
     /** number of bits per single pixel in buffer */
     static const uint8_t BITS_PER_PIXEL = BPP;
 
-    /** Fixed offset for all operation of NanoCanvasOps in pixels */
+    /**
+     * Fixed offset for all operation of NanoCanvasOps in pixels.
+     */
     NanoPoint offset;
 
     /**
@@ -96,7 +116,7 @@ public:
      * @param ox - X offset in pixels
      * @param oy - Y offset in pixels
      */
-    void setOffset(lcdint_t ox, lcdint_t oy) { offset.x = ox; offset.y = oy; };
+    void setOffset(lcdint_t ox, lcdint_t oy) { offset.x = ox; offset.y = oy; updateClip(); };
 
     /**
      * Returns right-bottom point of the canvas in offset terms.
@@ -116,6 +136,56 @@ public:
         return { offset, offsetEnd() };
     }
 
+    /**
+     * Restricts all drawing operations to specified area. The area is intersected
+     * with the current clip area, so nested clip areas can only shrink it.
+     * The area is specified in offset terms, so it doesn't depend on canvas offset,
+     * and remains the same for all tiles of NanoEngine.
+     *
+     * @param area area to restrict drawing to
+     * @return false if there is no more space in clip stack. In this case
+     *         clip area is not changed, and popClip() must not be called.
+     */
+    bool pushClip(const NanoRect &area)
+    {
+        if ( m_clipDepth >= CANVAS_CLIP_STACK_DEPTH )
+        {
+            return false;
+        }
+        NanoRect clip = area;
+        if ( m_clipDepth )
+        {
+            clip.crop( m_clipStack[m_clipDepth - 1] );
+        }
+        m_clipStack[m_clipDepth++] = clip;
+        updateClip();
+        return true;
+    }
+
+    /**
+     * Restores clip area, which was active before last pushClip() call.
+     */
+    void popClip()
+    {
+        if ( m_clipDepth ) m_clipDepth--;
+        updateClip();
+    }
+
+    /**
+     * Returns area, available for drawing operations, in offset terms.
+     * If clip area is not set, returns the same value as rect().
+     * If nothing can be drawn, returned rectangle has p1 greater than p2.
+     */
+    const NanoRect clipRect() const
+    {
+        NanoRect clip = rect();
+        if ( m_clipDepth )
+        {
+            clip.crop( m_clipStack[m_clipDepth - 1] );
+        }
+        return clip;
+    }
+
     /**
      * Draws pixel on specified position
      * @param x - position X
@@ -208,6 +278,54 @@ public:
      */
     void drawCircle(lcdint_t x, lcdint_t y, lcdint_t r) __attribute__ ((noinline));
 
+    /**
+     * Fills circle. Filled area covers all pixels of drawCircle() with the same arguments.
+     * @param x horizontal position of circle center in pixels
+     * @param y vertical position of circle center in pixels
+     * @param r circle radius in pixels
+     * @note color can be set via setColor()
+     */
+    void fillCircle(lcdint_t x, lcdint_t y, lcdint_t r) __attribute__ ((noinline));
+
+    /**
+     * Fills rectangle area with rounded corners
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @param r - radius of corners in pixels. It is limited by half of rectangle size.
+     * @note color can be set via setColor()
+     */
+    void fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t r) __attribute__ ((noinline));
+
+    /**
+     * Fills triangle. All vertices are included to filled area.
+     * The result is the same as fillPolygon() with 3 vertices gives.
+     * @param x1 - position X of 1st vertex
+     * @param y1 - position Y of 1st vertex
+     * @param x2 - position X of 2nd vertex
+     * @param y2 - position Y of 2nd vertex
+     * @param x3 - position X of 3rd vertex
+     * @param y3 - position Y of 3rd vertex
+     * @note color can be set via setColor()
+     */
+    void fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2,
+                      lcdint_t x3, lcdint_t y3) __attribute__ ((noinline));
+
+    /**
+     * Fills polygon, using even-odd rule. Each row is filled between pairs of
+     * polygon edges, crossing the row. Horizontal edges are skipped. Other edges
+     * include their upper end point, and include lower end point only on the
+     * bottom row of polygon. So vertices, which are lower end points of both
+     * neighbour edges (like tip of downward spike or bottom of the notch), are
+     * not filled above the bottom row, unless other part of polygon covers them.
+     * @param points - array of polygon vertices
+     * @param count - number of vertices, up to CANVAS_POLYGON_MAX_POINTS.
+     *        Polygons with more vertices are not drawn.
+     * @note color can be set via setColor()
+     */
+    void fillPolygon(const NanoPoint *points, uint8_t count) __attribute__ ((noinline));
+
     /**
      * @brief Draws monochrome bitmap in color buffer using color, specified via setColor() method
      * Draws monochrome bitmap in color buffer using color, specified via setColor() method
@@ -322,6 +440,27 @@ public:
      */
     NanoFont &getFont() { return *m_font; }
 
+    /**
+     * Copies drawing settings (colors, mode, font and clip areas) from another canvas.
+     * Canvas size, offset and pixels data are not changed. Clip areas are in offset
+     * terms, so they restrict the same area of the screen for both canvases.
+     *
+     * @param canvas canvas to copy settings from
+     */
+    void copySettings(const NanoCanvasOps<BPP> &canvas)
+    {
+        m_textMode = canvas.m_textMode;
+        m_color = canvas.m_color;
+        m_bgColor = canvas.m_bgColor;
+        m_font = canvas.m_font;
+        for (uint8_t i = 0; i < canvas.m_clipDepth; i++)
+        {
+            m_clipStack[i] = canvas.m_clipStack[i];
+        }
+        m_clipDepth = canvas.m_clipDepth;
+        updateClip();
+    }
+
     /**
      * Sets font spacing for currently active font
      * @param spacing spacing in pixels
@@ -373,8 +512,8 @@ public:
     lcduint_t height() { return m_h; }
 
 protected:
-    lcduint_t m_w;    ///< width of NanoCanvas area in pixels
-    lcduint_t m_h;    ///< height of NanoCanvas area in pixels
+    lcduint_t m_w = 0;    ///< width of NanoCanvas area in pixels
+    lcduint_t m_h = 0;    ///< height of NanoCanvas area in pixels
     lcdint_t  m_cursorX;  ///< current X cursor position for text output
     lcdint_t  m_cursorY;  ///< current Y cursor position for text output
     uint8_t   m_textMode; ///< Flags for current NanoCanvas mode
@@ -383,6 +522,49 @@ protected:
     uint16_t  m_color;    ///< current color
     uint16_t  m_bgColor;  ///< current background color
     NanoFont *m_font = nullptr; ///< current set font to use with NanoCanvas
+    NanoRect  m_clipStack[CANVAS_CLIP_STACK_DEPTH]; ///< clip areas in offset terms
+    uint8_t   m_clipDepth = 0; ///< number of active clip areas
+    mutable NanoRect  m_clip = { {0, 0}, {-1, -1} }; ///< drawing area in canvas buffer coordinates
+    mutable NanoPoint m_clipOffset = { 0, 0 }; ///< offset, m_clip is calculated for
+
+    /**
+     * Returns area, available for drawing operations, in canvas buffer coordinates.
+     * If nothing can be drawn, returns {{0, 0}, {-1, -1}}.
+     * offset is public field, and can be changed directly, so the area is
+     * recalculated here, if offset is changed while clip area is set.
+     */
+    const NanoRect &localClip() const
+    {
+        if ( m_clipDepth && m_clipOffset != offset )
+        {
+            updateClip();
+        }
+        return m_clip;
+    }
+
+    /**
+     * Recalculates drawing area. It is called when canvas size, offset or
+     * clip area changes, so that primitives do not calculate it for each pixel.
+     */
+    void updateClip() const
+    {
+        m_clipOffset = offset;
+        m_clip = { {0, 0}, {(lcdint_t)(m_w - 1), (lcdint_t)(m_h - 1)} };
+        if ( m_clipDepth )
+        {
+            m_clip.crop( m_clipStack[m_clipDepth - 1] - offset );
+            if ( (m_clip.p1.x > m_clip.p2.x) || (m_clip.p1.y > m_clip.p2.y) )
+            {
+                m_clip = { {0, 0}, {-1, -1} };
+            }
+        }
+    }
+
+    /**
+     * Fills shape, made of four circle quadrants with centers in the corners of
+     * specified rectangle, and the rectangle, expanded by radius in every direction.
+     */
+    void fillRoundArea(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t r);
 };
 
 /**
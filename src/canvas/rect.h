@@ -196,7 +196,7 @@ typedef struct _NanoRect
      * Returns true if specified point is above rectangle area.
      * @param p - point to check.
      */
-    _NanoRect operator-(const _NanoPoint &p)
+    _NanoRect operator-(const _NanoPoint &p) const
     {
         return { {static_cast<lcdint_t>(p1.x - p.x), static_cast<lcdint_t>(p1.y - p.y) },
                  {static_cast<lcdint_t>(p2.x - p.x), static_cast<lcdint_t>(p2.y - p.y) } };
@@ -206,7 +206,7 @@ typedef struct _NanoRect
      * Add point to all points of rectangle.
      * @param p - point to add.
      */
-    _NanoRect operator+(const _NanoPoint &p)
+    _NanoRect operator+(const _NanoPoint &p) const
     {
         return { {static_cast<lcdint_t>(p1.x + p.x), static_cast<lcdint_t>(p1.y + p.y) },
                  {static_cast<lcdint_t>(p2.x + p.x), static_cast<lcdint_t>(p2.y + p.y) } };
@@ -112,6 +112,14 @@
  */
 #define CONFIG_SSD1306_UNICODE_ENABLE
 
+/**
+ * Define this macro to compile out statistics, collected by InterfaceStats wrapper.
+ * The wrapper then passes all calls directly to the interface.
+ */
+#ifndef CONFIG_INTERFACE_STATS_DISABLE
+//#define CONFIG_INTERFACE_STATS_DISABLE
+#endif
+
 /**
  * @}
  */
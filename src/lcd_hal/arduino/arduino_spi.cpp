@@ -92,6 +92,24 @@ void ArduinoSpi::sendBuffer(const uint8_t *buffer, uint16_t size)
     };
 }
 
+void ArduinoSpi::sendRepeat(uint16_t pattern, uint32_t count)
+{
+    /* transfer16() sends most significant byte first for MSBFIRST bit order */
+    while (count--)
+    {
+        SPI.transfer16(pattern);
+    }
+}
+
+void ArduinoSpi::sendPixels16(const uint16_t *pixels, uint32_t count)
+{
+    while (count--)
+    {
+        SPI.transfer16(*pixels);
+        pixels++;
+    }
+}
+
 #endif
 
 #if defined(CONFIG_ARDUINO_SPI2_AVAILABLE) && defined(CONFIG_ARDUINO_SPI_ENABLE)
@@ -160,6 +178,24 @@ void ArduinoSpi2::sendBuffer(const uint8_t *buffer, uint16_t size)
     };
 }
 
+void ArduinoSpi2::sendRepeat(uint16_t pattern, uint32_t count)
+{
+    /* transfer16() sends most significant byte first for MSBFIRST bit order */
+    while (count--)
+    {
+        SPI2.transfer16(pattern);
+    }
+}
+
+void ArduinoSpi2::sendPixels16(const uint16_t *pixels, uint32_t count)
+{
+    while (count--)
+    {
+        SPI2.transfer16(*pixels);
+        pixels++;
+    }
+}
+
 #endif
 
 #endif // ARDUINO
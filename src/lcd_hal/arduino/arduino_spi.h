@@ -81,6 +81,22 @@ public:
      */
     void sendBuffer(const uint8_t *buffer, uint16_t size);
 
+    /**
+     * Sends 16-bit word to the device specified number of times.
+     * The word is sent most significant byte first.
+     * @param pattern - 16-bit word to send, for example, RGB565 color
+     * @param count - number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count);
+
+    /**
+     * Sends array of 16-bit words to the device.
+     * Each word is sent most significant byte first.
+     * @param pixels - 16-bit words to send, for example, RGB565 pixels
+     * @param count - number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count);
+
 private:
     int8_t m_cs;
     int8_t m_dc;
@@ -145,6 +161,22 @@ public:
      */
     void sendBuffer(const uint8_t *buffer, uint16_t size);
 
+    /**
+     * Sends 16-bit word to the device specified number of times.
+     * The word is sent most significant byte first.
+     * @param pattern - 16-bit word to send, for example, RGB565 color
+     * @param count - number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count);
+
+    /**
+     * Sends array of 16-bit words to the device.
+     * Each word is sent most significant byte first.
+     * @param pixels - 16-bit words to send, for example, RGB565 pixels
+     * @param count - number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count);
+
 private:
     int8_t m_cs;
     int8_t m_dc;
@@ -142,5 +142,36 @@ void AvrSpi::sendBuffer(const uint8_t *buffer, uint16_t size)
     }
 }
 
+void AvrSpi::sendRepeat(uint16_t pattern, uint32_t count)
+{
+    uint8_t hi = pattern >> 8;
+    uint8_t lo = pattern & 0xFF;
+    while (count--)
+    {
+        SPDR = hi;
+        asm volatile("nop");
+        while((SPSR & (1<<SPIF))==0);
+        SPDR = lo;
+        asm volatile("nop");
+        while((SPSR & (1<<SPIF))==0);
+    }
+    SPDR; // read SPI input
+}
+
+void AvrSpi::sendPixels16(const uint16_t *pixels, uint32_t count)
+{
+    while (count--)
+    {
+        SPDR = *pixels >> 8;
+        asm volatile("nop");
+        while((SPSR & (1<<SPIF))==0);
+        SPDR = *pixels & 0xFF;
+        asm volatile("nop");
+        while((SPSR & (1<<SPIF))==0);
+        pixels++;
+    }
+    SPDR; // read SPI input
+}
+
 #endif
 
@@ -0,0 +1,114 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file lcd_hal/interface_ops.h Generic 16-bit transfer operations for interface classes.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+/**
+ * @ingroup SSD1306_HAL_API
+ * @{
+ */
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/* int argument prefers the overload, which is valid only if interface class *
+ * has its own method. Otherwise, long overload falls back to send() calls.   */
+template <class I>
+inline auto _lcd_sendRepeat(I &intf, uint16_t pattern, uint32_t count, int)
+    -> decltype( intf.sendRepeat( pattern, count ), void() )
+{
+    intf.sendRepeat( pattern, count );
+}
+
+template <class I>
+inline void _lcd_sendRepeat(I &intf, uint16_t pattern, uint32_t count, long)
+{
+    while (count--)
+    {
+        intf.send( pattern >> 8 );
+        intf.send( pattern & 0xFF );
+    }
+}
+
+template <class I>
+inline auto _lcd_sendPixels16(I &intf, const uint16_t *pixels, uint32_t count, int)
+    -> decltype( intf.sendPixels16( pixels, count ), void() )
+{
+    intf.sendPixels16( pixels, count );
+}
+
+template <class I>
+inline void _lcd_sendPixels16(I &intf, const uint16_t *pixels, uint32_t count, long)
+{
+    while (count--)
+    {
+        intf.send( *pixels >> 8 );
+        intf.send( *pixels & 0xFF );
+        pixels++;
+    }
+}
+
+#endif
+
+/**
+ * Sends 16-bit word to the interface specified number of times, most significant
+ * byte first. Interface classes with faster transfer provide sendRepeat() method,
+ * all other classes, including custom ones, need to implement only send().
+ *
+ * @param intf interface to send data to
+ * @param pattern 16-bit word to send, for example, RGB565 color
+ * @param count number of times to send the word
+ */
+template <class I>
+inline void lcd_sendRepeat(I &intf, uint16_t pattern, uint32_t count)
+{
+    _lcd_sendRepeat( intf, pattern, count, 0 );
+}
+
+/**
+ * Sends array of 16-bit words to the interface, each word most significant
+ * byte first. Uses sendPixels16() method of the interface class if it exists,
+ * and send() otherwise.
+ *
+ * @param intf interface to send data to
+ * @param pixels 16-bit words to send, for example, RGB565 pixels
+ * @param count number of words to send
+ */
+template <class I>
+inline void lcd_sendPixels16(I &intf, const uint16_t *pixels, uint32_t count)
+{
+    _lcd_sendPixels16( intf, pixels, count, 0 );
+}
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,239 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file lcd_hal/interface_stats.h Instrumentation wrapper for interface classes.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+/**
+ * @ingroup SSD1306_HAL_API
+ * @{
+ */
+
+/** Number of buckets in latency histograms */
+#define LCD_STATS_HISTOGRAM_SIZE  16
+
+/**
+ * Statistics, collected by InterfaceStats. Latency histograms have logarithmic scale:
+ * bucket 0 counts durations below 1 microsecond, bucket N counts durations in range
+ * [2^(N-1), 2^N) microseconds, and the last bucket counts all longer durations.
+ */
+typedef struct
+{
+    uint32_t bytes;        ///< number of bytes sent
+    uint32_t starts;       ///< number of start() calls
+    uint32_t stops;        ///< number of stop() calls
+    uint32_t dcToggles;    ///< number of data/command mode switches
+    uint32_t blocks;       ///< number of startBlock() calls
+    uint32_t transactionUs[LCD_STATS_HISTOGRAM_SIZE]; ///< histogram of start()-stop() durations
+    uint32_t bufferUs[LCD_STATS_HISTOGRAM_SIZE];      ///< histogram of buffer sending durations
+} SInterfaceStats;
+
+#if !defined(CONFIG_INTERFACE_STATS_DISABLE)
+
+/**
+ * Wraps spi or i2c implementation (PlatformSpi, PlatformI2c or custom interface class)
+ * and collects statistics of data, sent to the display. Use it as interface argument
+ * of custom display templates, for example, DisplaySSD1331_96x64x8_CustomSPI<InterfaceStats<PlatformSpi>>.
+ * Data/command mode switches and startBlock() calls are reported by display interface classes.
+ * Durations are measured with lcd_micros().
+ * If CONFIG_INTERFACE_STATS_DISABLE is defined, the wrapper passes all calls directly
+ * to the interface and collects nothing.
+ */
+template <class I>
+class InterfaceStats: public I
+{
+public:
+    using I::I;
+
+    /**
+     * Starts communication with the display
+     */
+    void start()
+    {
+        m_stats.starts++;
+        m_startUs = lcd_micros();
+        I::start();
+    }
+
+    /**
+     * Ends communication with the display
+     */
+    void stop()
+    {
+        I::stop();
+        m_stats.stops++;
+        addLatency( m_stats.transactionUs, lcd_micros() - m_startUs );
+    }
+
+    /**
+     * Sends byte to the display
+     * @param data byte to send
+     */
+    void send(uint8_t data)
+    {
+        m_stats.bytes++;
+        I::send( data );
+    }
+
+    /**
+     * Sends bytes to the display
+     * @param buffer bytes to send
+     * @param size number of bytes to send
+     */
+    void sendBuffer(const uint8_t *buffer, uint16_t size)
+    {
+        uint32_t ts = lcd_micros();
+        I::sendBuffer( buffer, size );
+        m_stats.bytes += size;
+        addLatency( m_stats.bufferUs, lcd_micros() - ts );
+    }
+
+    /**
+     * Sends 16-bit word to the display specified number of times
+     * @param pattern 16-bit word to send
+     * @param count number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count)
+    {
+        uint32_t ts = lcd_micros();
+        lcd_sendRepeat( static_cast<I &>( *this ), pattern, count );
+        m_stats.bytes += count * 2;
+        addLatency( m_stats.bufferUs, lcd_micros() - ts );
+    }
+
+    /**
+     * Sends array of 16-bit words to the display
+     * @param pixels 16-bit words to send
+     * @param count number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count)
+    {
+        uint32_t ts = lcd_micros();
+        lcd_sendPixels16( static_cast<I &>( *this ), pixels, count );
+        m_stats.bytes += count * 2;
+        addLatency( m_stats.bufferUs, lcd_micros() - ts );
+    }
+
+    /**
+     * Returns collected statistics
+     */
+    const SInterfaceStats &getStats() const { return m_stats; }
+
+    /**
+     * Resets collected statistics
+     */
+    void resetStats() { m_stats = SInterfaceStats{}; }
+
+    /**
+     * Called by display interface, when data/command mode is set
+     * @param mode 1 for data mode, 0 for command mode
+     */
+    void onDataMode(uint8_t mode)
+    {
+        if ( mode != m_mode )
+        {
+            m_mode = mode;
+            m_stats.dcToggles++;
+        }
+    }
+
+    /**
+     * Called by display interface from startBlock()
+     */
+    void onStartBlock() { m_stats.blocks++; }
+
+private:
+    SInterfaceStats m_stats{};
+    uint32_t m_startUs = 0;
+    uint8_t m_mode = 0xFF;
+
+    static void addLatency(uint32_t *histogram, uint32_t us)
+    {
+        uint8_t bucket = 0;
+        while ( us && bucket < LCD_STATS_HISTOGRAM_SIZE - 1 )
+        {
+            us >>= 1;
+            bucket++;
+        }
+        histogram[bucket]++;
+    }
+};
+
+/**
+ * Notifies interface statistics about data/command mode. Does nothing, if interface
+ * is not wrapped with InterfaceStats.
+ * @param intf interface class
+ * @param mode 1 for data mode, 0 for command mode
+ */
+template <class I>
+inline void lcd_notifyDataMode(I &intf, uint8_t mode) { (void)intf; (void)mode; }
+
+/** @copydoc lcd_notifyDataMode */
+template <class I>
+inline void lcd_notifyDataMode(InterfaceStats<I> &intf, uint8_t mode) { intf.onDataMode( mode ); }
+
+/**
+ * Notifies interface statistics about startBlock() call. Does nothing, if interface
+ * is not wrapped with InterfaceStats.
+ * @param intf interface class
+ */
+template <class I>
+inline void lcd_notifyStartBlock(I &intf) { (void)intf; }
+
+/** @copydoc lcd_notifyStartBlock */
+template <class I>
+inline void lcd_notifyStartBlock(InterfaceStats<I> &intf) { intf.onStartBlock(); }
+
+#else
+
+template <class I>
+class InterfaceStats: public I
+{
+public:
+    using I::I;
+
+    const SInterfaceStats &getStats() const { static const SInterfaceStats stats{}; return stats; }
+
+    void resetStats() { }
+};
+
+template <class I>
+inline void lcd_notifyDataMode(I &intf, uint8_t mode) { (void)intf; (void)mode; }
+
+template <class I>
+inline void lcd_notifyStartBlock(I &intf) { (void)intf; }
+
+#endif
+
+/**
+ * @}
+ */
+
+#endif
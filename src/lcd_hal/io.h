@@ -390,7 +390,7 @@ public:
      * @param config i2c platform configuration. Refer to SPlatformI2cConfig.
      */
     explicit PlatformI2c(const SPlatformI2cConfig &config)
-        : SdlI2c(config.scl, config.sda, config.addr) {}
+        : SdlI2c(config.scl, config.sda, config.addr, config.frequency) {}
 };
 #else
 /**
@@ -512,7 +512,7 @@ public:
      * @param config spi platform configuration. Refer to SPlatformSpiConfig.
      */
     explicit PlatformSpi(const SPlatformSpiConfig &config)
-        : SdlSpi(config.dc) {}
+        : SdlSpi(config.dc, config.frequency) {}
 };
 #else
 /**
@@ -582,7 +582,9 @@ public:
 
 #endif
 
+#include "interface_ops.h"
 #include "custom_interface.h"
+#include "interface_stats.h"
 
 #endif
 
@@ -54,6 +54,22 @@ extern "C" {
 int min(int a, int b);
 int max(int a, int b);
 
+/**
+ * Changes root of gpio sysfs tree, used by linux gpio backend ("/sys/class/gpio"
+ * by default). This allows to run the backend against fake tree, for example,
+ * in unit tests.
+ * @param path new root of sysfs gpio tree or NULL to restore default one
+ */
+void lcd_linuxSetGpioSysfsPath(const char *path);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+int gpio_export(int pin);
+int gpio_unexport(int pin);
+int gpio_direction(int pin, int dir);
+int gpio_read(int pin);
+int gpio_write(int pin, int value);
+#endif
+
 static inline char *utoa(unsigned int num, char *str, int radix)
 {
     char temp[17];  //an int can only be 16 bits long
@@ -25,6 +25,7 @@
 #if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO)
 
 #include "../io.h"
+#include "linux_transfer_queue.h"
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -35,6 +36,7 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 #if defined(__linux__)
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <linux/spi/spidev.h>
 #endif
@@ -45,14 +47,23 @@
 #if defined(CONFIG_LINUX_I2C_AVAILABLE) && defined(CONFIG_LINUX_I2C_ENABLE) && \
     !defined(SDL_EMULATION)
 
+/* Number of transfer buffers, used in asynchronous mode */
+#define LINUX_I2C_ASYNC_BUFFERS  4
+
+/* Kernel limit for number of messages in single I2C_RDWR request */
+#define LINUX_I2C_MAX_SEGMENTS   42
+
 LinuxI2c::LinuxI2c(int8_t busId, uint8_t sa)
     : m_busId( busId )
     , m_sa( sa )
 {
+    setSegmentSize( m_segmentSize );
 }
 
 LinuxI2c::~LinuxI2c()
 {
+    delete m_queue;
+    m_queue = nullptr;
     if (m_fd >= 0)
     {
         close(m_fd);
@@ -79,10 +90,19 @@ void LinuxI2c::begin()
         fprintf(stderr, "Failed to acquire bus access and/or talk to slave.\n");
         return;
     }
+    unsigned long funcs = 0;
+    m_rdwr = ioctl(m_fd, I2C_FUNCS, &funcs) >= 0 && (funcs & I2C_FUNC_I2C);
+    if ( m_async && !m_queue )
+    {
+        m_queue = new LinuxTransferQueue( Transfer, this, sizeof(m_buffer), LINUX_I2C_ASYNC_BUFFERS );
+    }
 }
 
 void LinuxI2c::end()
 {
+    /* Destructor of the queue completes all pending transfers */
+    delete m_queue;
+    m_queue = nullptr;
     if (m_fd >= 0)
     {
         close(m_fd);
@@ -95,27 +115,135 @@ void LinuxI2c::start()
     m_dataSize = 0;
 }
 
-void LinuxI2c::stop()
+void LinuxI2c::setAsyncMode(bool enable)
+{
+    m_async = enable;
+    if ( !enable )
+    {
+        delete m_queue;
+        m_queue = nullptr;
+    }
+    else if ( m_fd >= 0 && !m_queue )
+    {
+        m_queue = new LinuxTransferQueue( Transfer, this, sizeof(m_buffer), LINUX_I2C_ASYNC_BUFFERS );
+    }
+}
+
+void LinuxI2c::setAddr(uint8_t addr)
+{
+    /* Queued transactions are still to be sent to previous address */
+    wait();
+    m_sa = addr;
+    if (m_fd >= 0 && !m_rdwr && ioctl(m_fd, I2C_SLAVE, m_sa) < 0)
+    {
+        fprintf(stderr, "Failed to acquire bus access and/or talk to slave.\n");
+    }
+}
+
+void LinuxI2c::setSegmentSize(uint16_t size)
+{
+    wait();
+    if ( size < 2 )
+    {
+        size = 2;
+    }
+    if ( size > sizeof(m_buffer) )
+    {
+        size = sizeof(m_buffer);
+    }
+    m_segmentSize = size;
+    /* Single transaction must fit both the buffer and I2C_RDWR limits */
+    uint16_t segments = sizeof(m_buffer) / size;
+    if ( segments > LINUX_I2C_MAX_SEGMENTS )
+    {
+        segments = LINUX_I2C_MAX_SEGMENTS;
+    }
+    m_capacity = segments * size;
+}
+
+void LinuxI2c::flush()
+{
+    wait();
+}
+
+void LinuxI2c::wait()
 {
-    if (write(m_fd, m_buffer, m_dataSize) != m_dataSize)
+    if ( m_queue )
+    {
+        m_queue->wait();
+    }
+}
+
+void LinuxI2c::Transfer(void *arg, const uint8_t *data, uint32_t size)
+{
+    LinuxI2c *obj = reinterpret_cast<LinuxI2c*>(arg);
+    /* Buffer is already split to segments, each starting with control byte */
+    if ( !obj->m_rdwr )
+    {
+        while ( size )
+        {
+            uint32_t len = size < obj->m_segmentSize ? size : obj->m_segmentSize;
+            if (write(obj->m_fd, data, len) != static_cast<ssize_t>(len))
+            {
+                fprintf(stderr, "Failed to write to the i2c bus: %s.\n", strerror(errno));
+            }
+            data += len;
+            size -= len;
+        }
+        return;
+    }
+    struct i2c_msg msgs[LINUX_I2C_MAX_SEGMENTS];
+    struct i2c_rdwr_ioctl_data packet;
+    packet.msgs = msgs;
+    packet.nmsgs = 0;
+    while ( size )
+    {
+        uint32_t len = size < obj->m_segmentSize ? size : obj->m_segmentSize;
+        struct i2c_msg &msg = msgs[packet.nmsgs++];
+        msg.addr = obj->m_sa;
+        msg.flags = 0;
+        msg.len = len;
+        msg.buf = const_cast<uint8_t *>(data);
+        data += len;
+        size -= len;
+    }
+    if ( packet.nmsgs && ioctl(obj->m_fd, I2C_RDWR, &packet) < 0 )
     {
         fprintf(stderr, "Failed to write to the i2c bus: %s.\n", strerror(errno));
     }
+}
+
+void LinuxI2c::stop()
+{
+    if ( m_queue )
+    {
+        m_queue->push( m_buffer, m_dataSize );
+    }
+    else
+    {
+        Transfer( this, m_buffer, m_dataSize );
+    }
     m_dataSize = 0;
 }
 
 void LinuxI2c::send(uint8_t data)
 {
-    m_buffer[m_dataSize] = data;
-    m_dataSize++;
-    if (m_dataSize == sizeof(m_buffer))
+    if ( m_dataSize && (m_dataSize % m_segmentSize) == 0 )
     {
-        /* Send function puts all data to internal buffer.  *
-         * Restart transmission if internal buffer is full. */
-        stop();
-        start();
-        send(0x40);
+        /* Each segment starts with the same control byte as the transaction */
+        uint8_t control = m_buffer[0];
+        if ( m_dataSize >= m_capacity )
+        {
+            /* Send function puts all data to internal buffer.  *
+             * Restart transmission if internal buffer is full. */
+            stop();
+            start();
+        }
+        m_buffer[m_dataSize] = control;
+        m_dataSize++;
     }
+    m_buffer[m_dataSize] = data;
+    m_dataSize++;
 }
 
 void LinuxI2c::sendBuffer(const uint8_t *buffer, uint16_t size)
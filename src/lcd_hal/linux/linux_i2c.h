@@ -32,6 +32,8 @@
 #if defined(CONFIG_LINUX_I2C_AVAILABLE) && defined(CONFIG_LINUX_I2C_ENABLE) && \
     !defined(SDL_EMULATION)
 
+class LinuxTransferQueue;
+
 /**
  * Class implements i2c interface for Linux via i2c-dev
  */
@@ -91,14 +93,57 @@ public:
      *
      * @param addr i2c address to set (7 bits)
      */
-    void setAddr(uint8_t addr) { m_sa = addr; }
+    void setAddr(uint8_t addr);
+
+    /**
+     * @brief Sets maximum size of single i2c message
+     *
+     * Data of one transaction are sent to the device by single I2C_RDWR request as
+     * the list of i2c messages. Each message is limited by segment size and starts
+     * with the same control byte as the first one (0x00 for commands, 0x40 for data).
+     * Large segments reduce overhead, but some i2c adapters limit message length.
+     * Default segment size is 1024 bytes.
+     *
+     * @param size maximum size of i2c message in bytes, including control byte
+     */
+    void setSegmentSize(uint16_t size);
+
+    /**
+     * @brief Enables asynchronous mode
+     *
+     * In asynchronous mode each i2c transaction is copied to the ring of preallocated
+     * buffers on stop(), and written to i2c-dev by separate I/O thread. So, stop()
+     * returns immediately, and the application can prepare next block, while previous
+     * one is being sent.
+     *
+     * @param enable true to enable asynchronous mode, false to send data in caller thread
+     */
+    void setAsyncMode(bool enable);
+
+    /**
+     * Waits until all started transactions are transferred to the device.
+     * I2C transaction can't be split, so data are queued on stop() only.
+     */
+    void flush();
+
+    /**
+     * Waits until all queued transactions are completed. Does nothing in synchronous mode.
+     */
+    void wait();
 
 private:
     int8_t m_busId;
     uint8_t m_sa;
     int m_fd = -1;
     uint16_t m_dataSize = 0;
-    uint8_t m_buffer[1024]{};
+    uint16_t m_segmentSize = 1024;
+    uint16_t m_capacity = 0;
+    bool m_rdwr = true;
+    uint8_t m_buffer[4096]{};
+    bool m_async = false;
+    LinuxTransferQueue *m_queue = nullptr;
+
+    static void Transfer(void *arg, const uint8_t *data, uint32_t size);
 };
 
 #endif
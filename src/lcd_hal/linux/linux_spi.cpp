@@ -25,6 +25,7 @@
 #if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO)
 
 #include "../io.h"
+#include "linux_transfer_queue.h"
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -45,6 +46,27 @@
 #if defined(CONFIG_LINUX_SPI_AVAILABLE) && defined(CONFIG_LINUX_SPI_ENABLE) && \
     !defined(SDL_EMULATION)
 
+/* Number of transfer buffers, used in asynchronous mode */
+#define LINUX_SPI_ASYNC_BUFFERS  4
+
+/* Maximum size of single spidev message. It is limited by bufsiz parameter of spidev *
+ * kernel module, 4096 bytes by default.                                             */
+static uint32_t spidev_bufsiz()
+{
+    uint32_t bufsiz = 4096;
+    FILE *f = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+    if ( f != nullptr )
+    {
+        unsigned int value = 0;
+        if ( fscanf(f, "%u", &value) == 1 && value > 0 )
+        {
+            bufsiz = value;
+        }
+        fclose(f);
+    }
+    return bufsiz;
+}
+
 LinuxSpi::LinuxSpi(int busId, int8_t devId, int8_t dcPin, uint32_t frequency)
     : m_busId( busId )
     , m_devId( devId )
@@ -57,6 +79,8 @@ LinuxSpi::LinuxSpi(int busId, int8_t devId, int8_t dcPin, uint32_t frequency)
 LinuxSpi::~LinuxSpi()
 {
     lcd_unregisterGpioEvent( m_dc );
+    delete m_queue;
+    m_queue = nullptr;
     if (m_spi_fd >= 0)
     {
         close(m_spi_fd);
@@ -93,10 +117,12 @@ void LinuxSpi::begin()
     {
         printf("Failed to set SPI mode: %s!\n", strerror(errno));
     }
-    uint8_t spi_bpw = 8;
-    if (ioctl (m_spi_fd, SPI_IOC_WR_BITS_PER_WORD, &spi_bpw) < 0)
+    setBitsPerWord();
+    m_spi_bufsiz = spidev_bufsiz();
+    m_dc_bit = m_dc >= 0 && lcd_gpioRead(m_dc) == LCD_HIGH ? 0x100 : 0;
+    if ( m_async && !m_queue )
     {
-        printf("Failed to set SPI BPW: %s!\n", strerror(errno));
+        m_queue = new LinuxTransferQueue( Transfer, this, m_spi_bufsiz, LINUX_SPI_ASYNC_BUFFERS );
     }
     // THIS IS HACK TO GET NOTIFICATIONS ON DC PIN CHANGE
     lcd_registerGpioEvent(m_dc, OnDcChange, this);
@@ -105,6 +131,9 @@ void LinuxSpi::begin()
 void LinuxSpi::end()
 {
     lcd_unregisterGpioEvent( m_dc );
+    /* Destructor of the queue completes all pending transfers */
+    delete m_queue;
+    m_queue = nullptr;
     if (m_spi_fd >= 0)
     {
         close(m_spi_fd);
@@ -122,39 +151,141 @@ void LinuxSpi::stop()
     sendCache();
 }
 
+void LinuxSpi::set9BitMode(bool enable)
+{
+    if ( m_9bit == enable )
+    {
+        return;
+    }
+    sendCache();
+    wait();
+    m_9bit = enable;
+    if (m_spi_fd >= 0)
+    {
+        setBitsPerWord();
+    }
+}
+
+void LinuxSpi::setAsyncMode(bool enable)
+{
+    m_async = enable;
+    if ( !enable )
+    {
+        sendCache();
+        delete m_queue;
+        m_queue = nullptr;
+    }
+    else if ( m_spi_fd >= 0 && !m_queue )
+    {
+        m_queue = new LinuxTransferQueue( Transfer, this, m_spi_bufsiz, LINUX_SPI_ASYNC_BUFFERS );
+    }
+}
+
+void LinuxSpi::flush()
+{
+    sendCache();
+    wait();
+}
+
+void LinuxSpi::wait()
+{
+    if ( m_queue )
+    {
+        m_queue->wait();
+    }
+}
+
+void LinuxSpi::setBitsPerWord()
+{
+    uint8_t spi_bpw = m_9bit ? 9 : 8;
+    if (ioctl (m_spi_fd, SPI_IOC_WR_BITS_PER_WORD, &spi_bpw) < 0)
+    {
+        printf("Failed to set SPI BPW: %s!\n", strerror(errno));
+        if ( m_9bit )
+        {
+            m_9bit = false;
+            setBitsPerWord();
+        }
+    }
+}
+
 void LinuxSpi::OnDcChange(void *arg)
 {
     LinuxSpi *obj = reinterpret_cast<LinuxSpi*>(arg);
+    if ( obj->m_9bit )
+    {
+        /* D/C flag goes with each word, so command and data runs are queued *
+         * together and submitted by a single transfer                       */
+        obj->m_dc_bit = obj->m_dc >= 0 && lcd_gpioRead( obj->m_dc ) == LCD_HIGH ? 0x100 : 0;
+        return;
+    }
     obj->sendCache();
+    /* D/C pin is changed right after this callback, so queued data must be sent */
+    obj->wait();
 }
 
-void LinuxSpi::sendCache()
+void LinuxSpi::transfer(const uint8_t *data, uint32_t size)
 {
-    /* TODO: Yeah, sending single bytes is too slow, but *
-     * need to figure out how to detect data/command bytes *
-     * to send bytes as one block */
-    if ( m_spi_cached_count == 0 )
+    if ( m_queue )
     {
+        m_queue->push( data, size );
         return;
     }
+    Transfer( this, data, size );
+}
+
+void LinuxSpi::Transfer(void *arg, const uint8_t *data, uint32_t size)
+{
+    LinuxSpi *obj = reinterpret_cast<LinuxSpi*>(arg);
     struct spi_ioc_transfer mesg;
     memset(&mesg, 0, sizeof mesg);
-    mesg.tx_buf = (unsigned long)&m_spi_cache[0];
+    mesg.tx_buf = (unsigned long)data;
     mesg.rx_buf = 0;
-    mesg.len = m_spi_cached_count;
+    mesg.len = size;
     mesg.delay_usecs = 0;
     mesg.speed_hz = 0;
-    mesg.bits_per_word = 8;
+    mesg.bits_per_word = obj->m_9bit ? 9 : 8;
     mesg.cs_change = 0;
-    if (ioctl(m_spi_fd, SPI_IOC_MESSAGE(1), &mesg) < 1)
+    if (ioctl(obj->m_spi_fd, SPI_IOC_MESSAGE(1), &mesg) < 1)
     {
         fprintf(stderr, "SPI failed to send SPI message: %s\n", strerror (errno)) ;
     }
+}
+
+void LinuxSpi::sendCache()
+{
+    /* In 8-bit mode the cache is sent each time D/C pin changes its state. *
+     * 9-bit words carry D/C flag, so the cache is sent only when it is     *
+     * full or communication is stopped.                                    */
+    if ( m_spi_cached_count == 0 )
+    {
+        return;
+    }
+    if ( m_9bit )
+    {
+        /* spidev expects words of 9..16 bits in native 16-bit format */
+        transfer( reinterpret_cast<const uint8_t *>(m_spi_words), m_spi_cached_count * 2 );
+    }
+    else
+    {
+        transfer( m_spi_cache, m_spi_cached_count );
+    }
     m_spi_cached_count = 0;
 }
 
 void LinuxSpi::send(uint8_t data)
 {
+    if ( m_9bit )
+    {
+        m_spi_words[m_spi_cached_count] = m_dc_bit | data;
+        m_spi_cached_count++;
+        if ( m_spi_cached_count >= sizeof( m_spi_words ) / sizeof( m_spi_words[0] ) ||
+             m_spi_cached_count * 2u >= m_spi_bufsiz )
+        {
+            sendCache();
+        }
+        return;
+    }
     m_spi_cache[m_spi_cached_count] = data;
     m_spi_cached_count++;
     if ( m_spi_cached_count >= sizeof( m_spi_cache ) )
@@ -165,10 +296,111 @@ void LinuxSpi::send(uint8_t data)
 
 void LinuxSpi::sendBuffer(const uint8_t *buffer, uint16_t size)
 {
-    while (size--)
+    if ( m_9bit )
+    {
+        /* Each byte is expanded to 9-bit word anyway */
+        while (size--)
+        {
+            send( *buffer++ );
+        }
+        return;
+    }
+    /* Small blocks are cheaper to accumulate in the cache along with other bytes */
+    if ( m_spi_cached_count + size <= sizeof( m_spi_cache ) )
+    {
+        memcpy( &m_spi_cache[m_spi_cached_count], buffer, size );
+        m_spi_cached_count += size;
+        if ( m_spi_cached_count >= sizeof( m_spi_cache ) )
+        {
+            sendCache();
+        }
+        return;
+    }
+    /* Large blocks are passed to spidev directly from user buffer, *
+     * splitting them to the chunks, accepted by the driver         */
+    sendCache();
+    while (size)
+    {
+        uint32_t len = size < m_spi_bufsiz ? size : m_spi_bufsiz;
+        transfer( buffer, len );
+        buffer += len;
+        size -= len;
+    }
+}
+
+void LinuxSpi::sendRepeat(uint16_t pattern, uint32_t count)
+{
+    if ( m_9bit || m_spi_cached_count + count * 2 <= sizeof( m_spi_cache ) )
+    {
+        /* Short runs are accumulated in the cache along with other bytes */
+        while (count--)
+        {
+            send( pattern >> 8 );
+            send( pattern & 0xFF );
+        }
+        return;
+    }
+    sendCache();
+    /* Fill buffer is built once per pattern and passed to spidev as many *
+     * times as needed, so long runs are sent at bus speed                 */
+    uint32_t fill_size = sizeof( m_spi_fill ) < m_spi_bufsiz ? sizeof( m_spi_fill ) : m_spi_bufsiz;
+    fill_size &= ~1u;
+    if ( m_spi_fill_pattern != pattern || m_spi_fill_size != fill_size )
+    {
+        for (uint32_t i = 0; i < fill_size; i += 2)
+        {
+            m_spi_fill[i] = pattern >> 8;
+            m_spi_fill[i + 1] = pattern & 0xFF;
+        }
+        m_spi_fill_pattern = pattern;
+        m_spi_fill_size = fill_size;
+    }
+    while (count)
+    {
+        uint32_t words = count < fill_size / 2 ? count : fill_size / 2;
+        transfer( m_spi_fill, words * 2 );
+        count -= words;
+    }
+}
+
+void LinuxSpi::sendPixels16(const uint16_t *pixels, uint32_t count)
+{
+    if ( m_9bit )
+    {
+        while (count--)
+        {
+            send( *pixels >> 8 );
+            send( *pixels & 0xFF );
+            pixels++;
+        }
+        return;
+    }
+    while (count)
     {
-        send(*buffer);
-        buffer++;
+        /* Pixels are converted to big-endian directly in the cache */
+        uint32_t words = (sizeof( m_spi_cache ) - m_spi_cached_count) / 2;
+        if ( words == 0 )
+        {
+            sendCache();
+            continue;
+        }
+        if ( words > count )
+        {
+            words = count;
+        }
+        uint8_t *dst = &m_spi_cache[m_spi_cached_count];
+        for (uint32_t i = 0; i < words; i++)
+        {
+            *dst++ = pixels[i] >> 8;
+            *dst++ = pixels[i] & 0xFF;
+        }
+        pixels += words;
+        count -= words;
+        m_spi_cached_count += words * 2;
+        if ( m_spi_cached_count >= sizeof( m_spi_cache ) - 1 )
+        {
+            sendCache();
+        }
     }
 }
 
@@ -32,6 +32,8 @@
 #if defined(CONFIG_LINUX_SPI_AVAILABLE) && defined(CONFIG_LINUX_SPI_ENABLE) && \
     !defined(SDL_EMULATION)
 
+class LinuxTransferQueue;
+
 /**
  * Class implements spi bus for linux via spidev interface
  */
@@ -87,6 +89,61 @@ public:
      */
     void sendBuffer(const uint8_t *buffer, uint16_t size);
 
+    /**
+     * Sends 16-bit word to the device specified number of times.
+     * The word is sent most significant byte first.
+     * @param pattern - 16-bit word to send, for example, RGB565 color
+     * @param count - number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count);
+
+    /**
+     * Sends array of 16-bit words to the device.
+     * Each word is sent most significant byte first.
+     * @param pixels - 16-bit words to send, for example, RGB565 pixels
+     * @param count - number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count);
+
+    /**
+     * @brief Enables 9-bit (3-wire) SPI mode
+     *
+     * In 9-bit mode data/command flag is transmitted as the first bit of each 9-bit word
+     * instead of being set via D/C pin. This allows to send commands and data of the
+     * whole block in a single spidev transfer. The mode is supported by some controllers
+     * only (for example, ILI9341, SSD1306 3-wire mode), and requires spi master, capable
+     * of 9 bits per word. If spi master doesn't support 9 bits per word, the interface
+     * falls back to regular 8-bit mode.
+     * D/C pin number passed to constructor is still used to track data/command mode,
+     * so it should be valid gpio pin, which can be left unconnected.
+     *
+     * @param enable true to enable 9-bit mode, false to use D/C pin
+     */
+    void set9BitMode(bool enable);
+
+    /**
+     * @brief Enables asynchronous mode
+     *
+     * In asynchronous mode the data are copied to the ring of preallocated buffers,
+     * and passed to spidev by separate I/O thread. So, stop() returns immediately,
+     * and the application can prepare next block, while previous one is being sent.
+     * Pending transfers are waited for automatically before D/C pin changes its state.
+     *
+     * @param enable true to enable asynchronous mode, false to send data in caller thread
+     */
+    void setAsyncMode(bool enable);
+
+    /**
+     * Sends all cached data and waits until they are transferred to the device.
+     */
+    void flush();
+
+    /**
+     * Waits until all queued transfers are completed. Data, not yet queued,
+     * are not sent. Does nothing in synchronous mode.
+     */
+    void wait();
+
 private:
     int m_busId;
     int8_t m_devId;
@@ -95,7 +152,19 @@ private:
     uint16_t m_spi_cached_count;
     uint8_t m_spi_cache[1024]{};
     int m_spi_fd = -1;
-
+    uint32_t m_spi_bufsiz = 4096;
+    bool m_9bit = false;
+    uint16_t m_dc_bit = 0;
+    uint16_t m_spi_words[1024]{};
+    bool m_async = false;
+    LinuxTransferQueue *m_queue = nullptr;
+    uint8_t m_spi_fill[4096]{};
+    uint32_t m_spi_fill_size = 0;
+    uint16_t m_spi_fill_pattern = 0;
+
+    void setBitsPerWord();
+    void transfer(const uint8_t *data, uint32_t size);
+    static void Transfer(void *arg, const uint8_t *data, uint32_t size);
     void sendCache();
     static void OnDcChange(void *arg);
 };
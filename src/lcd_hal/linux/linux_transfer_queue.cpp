@@ -0,0 +1,108 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO) && !defined(SDL_EMULATION)
+
+#include "linux_transfer_queue.h"
+
+#include <string.h>
+
+LinuxTransferQueue::LinuxTransferQueue(TransferFunc func, void *arg, uint32_t slotSize, uint8_t slotCount)
+    : m_func( func )
+    , m_arg( arg )
+    , m_slotSize( slotSize )
+    , m_slotCount( slotCount )
+    , m_slots( slotSize * slotCount )
+    , m_sizes( slotCount )
+{
+    m_thread = std::thread( &LinuxTransferQueue::run, this );
+}
+
+LinuxTransferQueue::~LinuxTransferQueue()
+{
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+void LinuxTransferQueue::push(const uint8_t *data, uint32_t size)
+{
+    while (size)
+    {
+        uint32_t len = size < m_slotSize ? size : m_slotSize;
+        std::unique_lock<std::mutex> lock( m_mutex );
+        while ( m_count == m_slotCount )
+        {
+            m_cond.wait( lock );
+        }
+        uint8_t slot = (m_head + m_count) % m_slotCount;
+        memcpy( &m_slots[slot * m_slotSize], data, len );
+        m_sizes[slot] = len;
+        m_count++;
+        lock.unlock();
+        m_cond.notify_all();
+        data += len;
+        size -= len;
+    }
+}
+
+void LinuxTransferQueue::wait()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while ( m_count || m_busy )
+    {
+        m_cond.wait( lock );
+    }
+}
+
+void LinuxTransferQueue::run()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    for (;;)
+    {
+        while ( !m_count && !m_stop )
+        {
+            m_cond.wait( lock );
+        }
+        if ( !m_count )
+        {
+            break;
+        }
+        uint8_t slot = m_head;
+        m_busy = true;
+        lock.unlock();
+        m_func( m_arg, &m_slots[slot * m_slotSize], m_sizes[slot] );
+        lock.lock();
+        m_head = (m_head + 1) % m_slotCount;
+        m_count--;
+        m_busy = false;
+        m_cond.notify_all();
+    }
+}
+
+#endif
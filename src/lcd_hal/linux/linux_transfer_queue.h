@@ -0,0 +1,102 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+/*
+ * @file lcd_hal/linux/linux_transfer_queue.h Background transfers for linux interfaces
+ */
+
+#ifndef _SSD1306V2_LINUX_LINUX_TRANSFER_QUEUE_H_
+#define _SSD1306V2_LINUX_LINUX_TRANSFER_QUEUE_H_
+
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO) && !defined(SDL_EMULATION)
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Ring of preallocated transfer buffers, drained by dedicated I/O thread.
+ * The class is used by LinuxSpi and LinuxI2c in async mode, and is not
+ * exposed via public headers to keep them free of threading includes.
+ */
+class LinuxTransferQueue
+{
+public:
+    /** Function, which passes single buffer to the hardware */
+    typedef void (*TransferFunc)(void *arg, const uint8_t *data, uint32_t size);
+
+    /**
+     * Creates transfer queue and starts I/O thread
+     *
+     * @param func function to call from I/O thread for each buffer
+     * @param arg argument to pass to func
+     * @param slotSize size of single transfer buffer in bytes
+     * @param slotCount number of transfer buffers in the ring
+     */
+    LinuxTransferQueue(TransferFunc func, void *arg, uint32_t slotSize, uint8_t slotCount);
+
+    /**
+     * Waits until all queued buffers are transferred and stops I/O thread
+     */
+    ~LinuxTransferQueue();
+
+    /**
+     * Copies data to the ring and returns immediately. Data larger than
+     * slot size is split to several transfers. If there is no free slot,
+     * the function waits until I/O thread completes the oldest transfer.
+     *
+     * @param data bytes to send
+     * @param size number of bytes to send
+     */
+    void push(const uint8_t *data, uint32_t size);
+
+    /**
+     * Waits until all queued buffers are transferred
+     */
+    void wait();
+
+private:
+    TransferFunc m_func;
+    void *m_arg;
+    uint32_t m_slotSize;
+    uint8_t m_slotCount;
+    std::vector<uint8_t> m_slots;
+    std::vector<uint32_t> m_sizes;
+    uint8_t m_head = 0;
+    uint8_t m_count = 0;
+    bool m_busy = false;
+    bool m_stop = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+
+    void run();
+};
+
+#endif
+
+#endif
@@ -41,7 +41,7 @@
 
 //#include <cstdlib>
 
-#include <map>
+#include <atomic>
 
 #if defined(CONFIG_LINUX_SPI_AVAILABLE) && defined(CONFIG_LINUX_SPI_ENABLE) \
     && !defined(SDL_EMULATION)
@@ -50,6 +50,11 @@
 
 #define MAX_GPIO_COUNT   256
 
+/* Default root of gpio sysfs tree. Can be changed in runtime via lcd_linuxSetGpioSysfsPath() */
+#ifndef CONFIG_LINUX_GPIO_SYSFS_PATH
+#define CONFIG_LINUX_GPIO_SYSFS_PATH  "/sys/class/gpio"
+#endif
+
 #ifdef IN
 #undef IN
 #endif
@@ -60,21 +65,75 @@
 #endif
 #define OUT 1
 
+/* Kept shorter than path buffers below, so that full path always fits */
+static char s_sysfs_path[96] = CONFIG_LINUX_GPIO_SYSFS_PATH;
+
+/* Opened value files of gpio pins. Descriptors are stored incremented by 1, *
+ * so zero-initialized table means that no file is opened yet.               */
+static int s_value_fd[MAX_GPIO_COUNT] = {0};
+
+static void gpio_close_value(int pin)
+{
+    if (pin >= 0 && pin < MAX_GPIO_COUNT && s_value_fd[pin])
+    {
+        close(s_value_fd[pin] - 1);
+        s_value_fd[pin] = 0;
+    }
+}
+
+/* Returns descriptor of value file, opening it only on the first access */
+static int gpio_value_fd(int pin)
+{
+    if (pin < 0 || pin >= MAX_GPIO_COUNT)
+    {
+        return -1;
+    }
+    if (!s_value_fd[pin])
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/gpio%d/value", s_sysfs_path, pin);
+        int fd = open(path, O_RDWR);
+        if (-1 == fd)
+        {
+            /* Input only pins do not allow writing */
+            fd = open(path, O_RDONLY);
+        }
+        if (-1 == fd)
+        {
+            return -1;
+        }
+        s_value_fd[pin] = fd + 1;
+    }
+    return s_value_fd[pin] - 1;
+}
+
+void lcd_linuxSetGpioSysfsPath(const char *path)
+{
+    /* Cached descriptors belong to previous tree */
+    for (int pin = 0; pin < MAX_GPIO_COUNT; pin++)
+    {
+        gpio_close_value(pin);
+    }
+    snprintf(s_sysfs_path, sizeof(s_sysfs_path), "%s",
+             path ? path : CONFIG_LINUX_GPIO_SYSFS_PATH);
+}
+
 int gpio_export(int pin)
 {
     char buffer[4];
     ssize_t bytes_written;
     int fd;
-    char path[64];
+    char path[128];
 
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d", pin);
+    snprintf(path, sizeof(path), "%s/gpio%d", s_sysfs_path, pin);
 
     if (access(path, F_OK) == 0)
     {
         return 0;
     }
 
-    fd = open("/sys/class/gpio/export", O_WRONLY);
+    snprintf(path, sizeof(path), "%s/export", s_sysfs_path);
+    fd = open(path, O_WRONLY);
     if (-1 == fd)
     {
         fprintf(stderr, "Failed to allocate gpio pin[%d]: %s%s!\n",
@@ -99,8 +158,11 @@ int gpio_unexport(int pin)
     char buffer[4];
     ssize_t bytes_written;
     int fd;
+    char path[128];
 
-    fd = open("/sys/class/gpio/unexport", O_WRONLY);
+    gpio_close_value(pin);
+    snprintf(path, sizeof(path), "%s/unexport", s_sysfs_path);
+    fd = open(path, O_WRONLY);
     if (-1 == fd)
     {
         fprintf(stderr, "Failed to free gpio pin resources!\n");
@@ -120,10 +182,10 @@ int gpio_direction(int pin, int dir)
 {
     static const char s_directions_str[]  = "in\0out";
 
-    char path[64];
+    char path[128];
     int fd;
 
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/direction", pin);
+    snprintf(path, sizeof(path), "%s/gpio%d/direction", s_sysfs_path, pin);
     fd = open(path, O_WRONLY);
     if (-1 == fd)
     {
@@ -136,34 +198,36 @@ int gpio_direction(int pin, int dir)
     {
         fprintf(stderr, "Failed to set gpio pin direction2[%d]: %s!\n",
                 pin, strerror(errno));
+        close(fd);
         return(-1);
     }
 
     close(fd);
+    /* Access mode of value file depends on direction, so reopen it next time */
+    gpio_close_value(pin);
     return(0);
 }
 
 int gpio_read(int pin)
 {
-    char path[32];
-    char value_str[3];
+    char value_str[4];
     int fd;
 
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_RDONLY);
+    fd = gpio_value_fd(pin);
     if (-1 == fd)
     {
         fprintf(stderr, "Failed to read gpio pin value!\n");
         return(-1);
     }
 
-    if (-1 == read(fd, value_str, 3))
+    /* sysfs attribute is reread from the beginning, so single pread() is enough */
+    ssize_t len = pread(fd, value_str, sizeof(value_str) - 1, 0);
+    if (len <= 0)
     {
         fprintf(stderr, "Failed to read gpio pin value!\n");
         return(-1);
     }
-
-    close(fd);
+    value_str[len] = '\0';
 
     return(atoi(value_str));
 }
@@ -172,11 +236,9 @@ int gpio_write(int pin, int value)
 {
     static const char s_values_str[] = "01";
 
-    char path[64];
     int fd;
 
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_WRONLY);
+    fd = gpio_value_fd(pin);
     if (-1 == fd)
     {
         fprintf(stderr, "Failed to set gpio pin value[%d]: %s%s!\n",
@@ -184,14 +246,13 @@ int gpio_write(int pin, int value)
         return(-1);
     }
 
-    if (1 != write(fd, &s_values_str[LOW == value ? 0 : 1], 1))
+    if (1 != pwrite(fd, &s_values_str[LOW == value ? 0 : 1], 1, 0))
     {
         fprintf(stderr, "Failed to set gpio pin value[%d]: %s%s!\n",
                 pin, strerror (errno), getuid() == 0 ? "" : ", need to be root");
         return(-1);
     }
 
-    close(fd);
     return(0);
 }
 
@@ -243,18 +304,28 @@ void lcd_gpioMode(int pin, int mode)
 
 #elif !defined(SDL_EMULATION)
 
+/* Callback is published after its argument, and is cleared first on  *
+ * unregistering, so lcd_gpioWrite() can run on other threads without  *
+ * locks. Replacing callback of the pin while it is being written from  *
+ * other thread is not supported.                                       */
 typedef struct
 {
-    void (*on_pin_change)(void *);
-    void *arg;
+    std::atomic<void (*)(void *)> on_pin_change;
+    std::atomic<void *> arg;
 } SPinEvent;
 
 static uint8_t s_exported_pin[MAX_GPIO_COUNT] = {0};
 static uint8_t s_pin_mode[MAX_GPIO_COUNT] = {0};
-std::map<int, SPinEvent> s_events;
+/* Last level written to output pin plus 1, 0 if unknown */
+static uint8_t s_pin_level[MAX_GPIO_COUNT] = {0};
+static SPinEvent s_events[MAX_GPIO_COUNT] {};
 
 void lcd_gpioMode(int pin, int mode)
 {
+    if (pin < 0 || pin >= MAX_GPIO_COUNT)
+    {
+        return;
+    }
     if (!s_exported_pin[pin])
     {
         if ( gpio_export(pin)<0 )
@@ -263,6 +334,9 @@ void lcd_gpioMode(int pin, int mode)
         }
         s_exported_pin[pin] = 1;
     }
+    /* Writing "out" to direction file drives the pin low, and input pin has *
+     * no written level at all, so cached level is not valid any more        */
+    s_pin_level[pin] = 0;
     if (mode == LCD_GPIO_OUTPUT)
     {
         gpio_direction(pin, OUT);
@@ -277,10 +351,25 @@ void lcd_gpioMode(int pin, int mode)
 
 void lcd_gpioWrite(int pin, int level)
 {
+    if (pin < 0 || pin >= MAX_GPIO_COUNT)
+    {
+        return;
+    }
+    level = level == LCD_LOW ? LCD_LOW : LCD_HIGH;
+    /* Output already has requested level, so there is nothing to notify about. *
+     * This also saves sysfs round trips for repeated D/C mode switches.        */
+    if (s_pin_level[pin] == level + 1)
+    {
+        return;
+    }
+    /* New level is stored before notification, so that handler can request it *
+     * via lcd_gpioRead()                                                       */
+    s_pin_level[pin] = level + 1;
 #ifdef LINUX_SPI_AVAILABLE
-    if (s_events.find(pin) != s_events.end())
+    void (*on_pin_change)(void *) = s_events[pin].on_pin_change.load( std::memory_order_acquire );
+    if ( on_pin_change )
     {
-        s_events[pin].on_pin_change( s_events[pin].arg );
+        on_pin_change( s_events[pin].arg.load( std::memory_order_relaxed ) );
     }
 #endif
 
@@ -288,6 +377,7 @@ void lcd_gpioWrite(int pin, int level)
     {
         if ( gpio_export(pin)<0 )
         {
+            s_pin_level[pin] = 0;
             return;
         }
         s_exported_pin[pin] = 1;
@@ -295,23 +385,50 @@ void lcd_gpioWrite(int pin, int level)
     if (!s_pin_mode[pin])
     {
         pinMode(pin, OUTPUT);
+        /* pinMode() drops cached level, but it is written right below */
+        s_pin_level[pin] = level + 1;
+    }
+    if ( gpio_write( pin, level ) < 0 )
+    {
+        s_pin_level[pin] = 0;
     }
-    gpio_write( pin, level );
 }
 
 void lcd_registerGpioEvent(int pin, void (*on_pin_change)(void *), void * arg)
 {
-    s_events[pin].arg = arg;
-    s_events[pin].on_pin_change = on_pin_change;
+    if (pin < 0 || pin >= MAX_GPIO_COUNT)
+    {
+        return;
+    }
+    s_events[pin].on_pin_change.store( nullptr, std::memory_order_relaxed );
+    s_events[pin].arg.store( arg, std::memory_order_relaxed );
+    s_events[pin].on_pin_change.store( on_pin_change, std::memory_order_release );
 }
 
 void lcd_unregisterGpioEvent(int pin)
 {
-    s_events.erase( pin );
+    if (pin < 0 || pin >= MAX_GPIO_COUNT)
+    {
+        return;
+    }
+    s_events[pin].on_pin_change.store( nullptr, std::memory_order_release );
 }
 
 int  lcd_gpioRead(int pin)
 {
+    if (pin < 0 || pin >= MAX_GPIO_COUNT)
+    {
+        return LCD_LOW;
+    }
+    /* Output pins report last written level */
+    if (s_pin_level[pin])
+    {
+        return s_pin_level[pin] - 1;
+    }
+    if (s_exported_pin[pin] && !s_pin_mode[pin])
+    {
+        return gpio_read(pin) > 0 ? LCD_HIGH : LCD_LOW;
+    }
     return LCD_LOW;
 }
 
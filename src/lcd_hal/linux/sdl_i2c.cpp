@@ -47,8 +47,10 @@
 
 #include "sdl_core.h"
 
-SdlI2c::SdlI2c(int8_t scl, int8_t sda, uint8_t sa)
+SdlI2c::SdlI2c(int8_t scl, int8_t sda, uint8_t sa, uint32_t frequency)
 //    m_scl( scl ), m_sda( sda )
+    : m_sa( sa )
+    , m_frequency( frequency )
 {
 }
 
@@ -60,6 +62,10 @@ SdlI2c::~SdlI2c()
 void SdlI2c::begin()
 {
     sdl_core_init();
+    if ( m_frequency )
+    {
+        sdl_core_set_i2c_frequency( m_frequency );
+    }
 }
 
 void SdlI2c::end()
@@ -84,10 +90,39 @@ void SdlI2c::send(uint8_t data)
 
 void SdlI2c::sendBuffer(const uint8_t *buffer, uint16_t size)
 {
-    while (size--)
+    sdl_send_buffer( buffer, size );
+}
+
+void SdlI2c::sendRepeat(uint16_t pattern, uint32_t count)
+{
+    uint8_t block[256];
+    for (unsigned i = 0; i < sizeof(block); i += 2)
+    {
+        block[i] = pattern >> 8;
+        block[i + 1] = pattern & 0xFF;
+    }
+    while ( count )
+    {
+        uint32_t words = count < sizeof(block) / 2 ? count : sizeof(block) / 2;
+        sdl_send_buffer( block, words * 2 );
+        count -= words;
+    }
+}
+
+void SdlI2c::sendPixels16(const uint16_t *pixels, uint32_t count)
+{
+    uint8_t block[256];
+    while ( count )
     {
-        send(*buffer);
-        buffer++;
+        uint32_t words = count < sizeof(block) / 2 ? count : sizeof(block) / 2;
+        for (uint32_t i = 0; i < words; i++)
+        {
+            block[i * 2] = pixels[i] >> 8;
+            block[i * 2 + 1] = pixels[i] & 0xFF;
+        }
+        sdl_send_buffer( block, words * 2 );
+        pixels += words;
+        count -= words;
     }
 }
 
@@ -41,8 +41,10 @@ public:
      * @param scl pin number to use as clock
      * @param sda pin number to use as data line
      * @param sa i2c address of the display (7 bits)
+     * @param frequency frequency of emulated i2c bus. If 0, emulator default is used.
+     *        It is used by the emulator to calculate bus transfer time.
      */
-    SdlI2c(int8_t scl = -1, int8_t sda = -1, uint8_t sa = 0x00);
+    SdlI2c(int8_t scl = -1, int8_t sda = -1, uint8_t sa = 0x00, uint32_t frequency = 0);
     ~SdlI2c();
 
     /**
@@ -82,6 +84,22 @@ public:
      */
     void sendBuffer(const uint8_t *buffer, uint16_t size);
 
+    /**
+     * Sends 16-bit word to the device specified number of times.
+     * The word is sent most significant byte first.
+     * @param pattern - 16-bit word to send, for example, RGB565 color
+     * @param count - number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count);
+
+    /**
+     * Sends array of 16-bit words to the device.
+     * Each word is sent most significant byte first.
+     * @param pixels - 16-bit words to send, for example, RGB565 pixels
+     * @param count - number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count);
+
     /**
      * Sets i2c address for communication
      * This API is required for some led displays having multiple
@@ -95,6 +113,7 @@ private:
 //    int8_t m_scl;
 //    int8_t m_sda;
     uint8_t m_sa;
+    uint32_t m_frequency;
 };
 
 #endif
@@ -49,8 +49,9 @@
 
 #include "sdl_core.h"
 
-SdlSpi::SdlSpi(int8_t dcPin)
+SdlSpi::SdlSpi(int8_t dcPin, uint32_t frequency)
    : m_dc( dcPin )
+   , m_frequency( frequency )
 {
 }
 
@@ -63,6 +64,10 @@ void SdlSpi::begin()
 {
     sdl_core_init();
     sdl_set_dc_pin( m_dc );
+    if ( m_frequency )
+    {
+        sdl_core_set_spi_frequency( m_frequency );
+    }
 }
 
 void SdlSpi::end()
@@ -87,10 +92,39 @@ void SdlSpi::send(uint8_t data)
 
 void SdlSpi::sendBuffer(const uint8_t *buffer, uint16_t size)
 {
-    while (size--)
+    sdl_send_buffer( buffer, size );
+}
+
+void SdlSpi::sendRepeat(uint16_t pattern, uint32_t count)
+{
+    uint8_t block[256];
+    for (unsigned i = 0; i < sizeof(block); i += 2)
+    {
+        block[i] = pattern >> 8;
+        block[i + 1] = pattern & 0xFF;
+    }
+    while ( count )
+    {
+        uint32_t words = count < sizeof(block) / 2 ? count : sizeof(block) / 2;
+        sdl_send_buffer( block, words * 2 );
+        count -= words;
+    }
+}
+
+void SdlSpi::sendPixels16(const uint16_t *pixels, uint32_t count)
+{
+    uint8_t block[256];
+    while ( count )
     {
-        send(*buffer);
-        buffer++;
+        uint32_t words = count < sizeof(block) / 2 ? count : sizeof(block) / 2;
+        for (uint32_t i = 0; i < words; i++)
+        {
+            block[i * 2] = pixels[i] >> 8;
+            block[i * 2 + 1] = pixels[i] & 0xFF;
+        }
+        sdl_send_buffer( block, words * 2 );
+        pixels += words;
+        count -= words;
     }
 }
 
@@ -39,8 +39,10 @@ public:
      * Creates spi bus instance for SPI in SDL Emulation mode.
      *
      * @param dcPin pin to use as data/command control pin
+     * @param frequency frequency of emulated spi bus. If 0, emulator default is used.
+     *        It is used by the emulator to calculate bus transfer time.
      */
-    explicit SdlSpi(int8_t dcPin = -1);
+    explicit SdlSpi(int8_t dcPin = -1, uint32_t frequency = 0);
 
     ~SdlSpi();
 
@@ -80,8 +82,25 @@ public:
      * @param size - number of bytes to send
      */
     void sendBuffer(const uint8_t *buffer, uint16_t size);
+
+    /**
+     * Sends 16-bit word to the device specified number of times.
+     * The word is sent most significant byte first.
+     * @param pattern - 16-bit word to send, for example, RGB565 color
+     * @param count - number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count);
+
+    /**
+     * Sends array of 16-bit words to the device.
+     * Each word is sent most significant byte first.
+     * @param pixels - 16-bit words to send, for example, RGB565 pixels
+     * @param count - number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count);
 private:
     int8_t m_dc;
+    uint32_t m_frequency;
 };
 
 #endif
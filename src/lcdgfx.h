@@ -46,6 +46,7 @@
 #include "v2/lcd/st7735/lcd_st7735.h"
 #include "v2/lcd/il9163/lcd_il9163.h"
 #include "v2/lcd/ili9341/lcd_ili9341.h"
+#include "v2/lcd/base/retained.h"
 
 extern "C" {
 #endif
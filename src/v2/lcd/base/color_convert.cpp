@@ -0,0 +1,169 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "color_convert.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/*
+ * RGB8_TO_RGB16() in big-endian form can be computed for each byte separately:
+ *   high byte = RRR00GGG: (c & 0xE0) | ((c >> 2) & 0x07)
+ *   low byte  = 000BB000: (c & 0x03) << 3
+ * So, 16 pixels are converted at once by vector instructions.
+ */
+void lcd_convertRgb8ToRgb16(uint8_t *dst, const uint8_t *src, lcduint_t count)
+{
+#if defined(__SSE2__)
+    const __m128i rg_mask = _mm_set1_epi8( static_cast<char>(0xE0) );
+    const __m128i g_mask = _mm_set1_epi8( 0x07 );
+    const __m128i b_mask = _mm_set1_epi8( 0x03 );
+    while ( count >= 16 )
+    {
+        __m128i c = _mm_loadu_si128( reinterpret_cast<const __m128i *>(src) );
+        __m128i hi = _mm_or_si128( _mm_and_si128( c, rg_mask ),
+                                   _mm_and_si128( _mm_srli_epi16( c, 2 ), g_mask ) );
+        __m128i lo = _mm_slli_epi16( _mm_and_si128( c, b_mask ), 3 );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8( hi, lo ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi8( hi, lo ) );
+        src += 16;
+        dst += 32;
+        count -= 16;
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint8x16_t rg_mask = vdupq_n_u8( 0xE0 );
+    const uint8x16_t g_mask = vdupq_n_u8( 0x07 );
+    const uint8x16_t b_mask = vdupq_n_u8( 0x03 );
+    while ( count >= 16 )
+    {
+        uint8x16_t c = vld1q_u8( src );
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8( vandq_u8( c, rg_mask ), vandq_u8( vshrq_n_u8( c, 2 ), g_mask ) );
+        out.val[1] = vshlq_n_u8( vandq_u8( c, b_mask ), 3 );
+        vst2q_u8( dst, out );
+        src += 16;
+        dst += 32;
+        count -= 16;
+    }
+#endif
+    while ( count-- )
+    {
+        uint8_t c = *src++;
+        *dst++ = (c & 0xE0) | ((c >> 2) & 0x07);
+        *dst++ = (c & 0x03) << 3;
+    }
+}
+
+void lcd_convertMonoToRgb16(uint8_t *dst, const uint8_t *src, uint8_t bit, lcduint_t count,
+                            uint16_t color, uint16_t bgColor)
+{
+    const uint8_t fg_hi = color >> 8;
+    const uint8_t fg_lo = color & 0xFF;
+    const uint8_t bg_hi = bgColor >> 8;
+    const uint8_t bg_lo = bgColor & 0xFF;
+#if defined(__SSE2__)
+    const __m128i vbit = _mm_set1_epi8( static_cast<char>(bit) );
+    const __m128i vfg_hi = _mm_set1_epi8( static_cast<char>(fg_hi) );
+    const __m128i vfg_lo = _mm_set1_epi8( static_cast<char>(fg_lo) );
+    const __m128i vbg_hi = _mm_set1_epi8( static_cast<char>(bg_hi) );
+    const __m128i vbg_lo = _mm_set1_epi8( static_cast<char>(bg_lo) );
+    while ( count >= 16 )
+    {
+        __m128i c = _mm_loadu_si128( reinterpret_cast<const __m128i *>(src) );
+        /* 0xFF for the pixels, having the bit cleared */
+        __m128i bg = _mm_cmpeq_epi8( _mm_and_si128( c, vbit ), _mm_setzero_si128() );
+        __m128i hi = _mm_or_si128( _mm_and_si128( bg, vbg_hi ), _mm_andnot_si128( bg, vfg_hi ) );
+        __m128i lo = _mm_or_si128( _mm_and_si128( bg, vbg_lo ), _mm_andnot_si128( bg, vfg_lo ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8( hi, lo ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi8( hi, lo ) );
+        src += 16;
+        dst += 32;
+        count -= 16;
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint8x16_t vbit = vdupq_n_u8( bit );
+    const uint8x16_t vfg_hi = vdupq_n_u8( fg_hi );
+    const uint8x16_t vfg_lo = vdupq_n_u8( fg_lo );
+    const uint8x16_t vbg_hi = vdupq_n_u8( bg_hi );
+    const uint8x16_t vbg_lo = vdupq_n_u8( bg_lo );
+    while ( count >= 16 )
+    {
+        /* 0xFF for the pixels, having the bit set */
+        uint8x16_t fg = vtstq_u8( vld1q_u8( src ), vbit );
+        uint8x16x2_t out;
+        out.val[0] = vbslq_u8( fg, vfg_hi, vbg_hi );
+        out.val[1] = vbslq_u8( fg, vfg_lo, vbg_lo );
+        vst2q_u8( dst, out );
+        src += 16;
+        dst += 32;
+        count -= 16;
+    }
+#endif
+    while ( count-- )
+    {
+        if ( *src & bit )
+        {
+            *dst++ = fg_hi;
+            *dst++ = fg_lo;
+        }
+        else
+        {
+            *dst++ = bg_hi;
+            *dst++ = bg_lo;
+        }
+        src++;
+    }
+}
+
+void lcd_convertGray4ToRgb16(uint8_t *dst, const uint8_t *src, lcduint_t count)
+{
+    /* 16 gray levels are expanded via small table: 5-bit and 6-bit levels are *
+     * produced by replicating upper bits of 4-bit level to the lower ones      */
+    uint8_t hi[16];
+    uint8_t lo[16];
+    for (uint8_t g = 0; g < 16; g++)
+    {
+        uint16_t color = ((g << 1) | (g >> 3));
+        color = (color << 11) | (((g << 2) | (g >> 2)) << 5) | color;
+        hi[g] = color >> 8;
+        lo[g] = color & 0xFF;
+    }
+    while ( count >= 2 )
+    {
+        uint8_t c = *src++;
+        *dst++ = hi[c & 0x0F];
+        *dst++ = lo[c & 0x0F];
+        *dst++ = hi[c >> 4];
+        *dst++ = lo[c >> 4];
+        count -= 2;
+    }
+    if ( count )
+    {
+        *dst++ = hi[*src & 0x0F];
+        *dst++ = lo[*src & 0x0F];
+    }
+}
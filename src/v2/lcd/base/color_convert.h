@@ -0,0 +1,89 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file v2/lcd/base/color_convert.h Pixel format conversion functions
+ */
+
+#ifndef _LCDGFX_COLOR_CONVERT_H_
+#define _LCDGFX_COLOR_CONVERT_H_
+
+#include "canvas/canvas_types.h"
+
+/**
+ * @ingroup LCD_INTERFACE_API_V2
+ * @{
+ */
+
+#ifndef LCD_CONVERT_CHUNK_PIXELS
+#if defined(__AVR__)
+/** Number of pixels, converted at once to the stack buffer before sending to the display */
+#define LCD_CONVERT_CHUNK_PIXELS  16
+#else
+/** Number of pixels, converted at once to the stack buffer before sending to the display */
+#define LCD_CONVERT_CHUNK_PIXELS  320
+#endif
+#endif
+
+/**
+ * Converts RGB 3-3-2 pixels to RGB 5-6-5 pixels. Output pixels are stored in big-endian
+ * order (most significant byte first), as expected by 16-bit display controllers.
+ * The conversion is the same as RGB8_TO_RGB16() does. SSE2 and NEON instructions
+ * are used when available.
+ *
+ * @param dst destination buffer, must have space for count * 2 bytes
+ * @param src source 8-bit pixels
+ * @param count number of pixels to convert
+ */
+void lcd_convertRgb8ToRgb16(uint8_t *dst, const uint8_t *src, lcduint_t count);
+
+/**
+ * Converts one row of 1-bit buffer to RGB 5-6-5 pixels. Each byte of the source
+ * buffer is vertical column of 8 pixels, as used by NanoCanvas1, so only one bit of
+ * each byte is taken. Output pixels are stored in big-endian order.
+ *
+ * @param dst destination buffer, must have space for count * 2 bytes
+ * @param src source 1-bit buffer, pointing to the first column of the row
+ * @param bit bit mask of the row in the page, for example 0x01 for the top row
+ * @param count number of pixels to convert
+ * @param color 16-bit color for the set bits
+ * @param bgColor 16-bit color for the cleared bits
+ */
+void lcd_convertMonoToRgb16(uint8_t *dst, const uint8_t *src, uint8_t bit, lcduint_t count,
+                            uint16_t color, uint16_t bgColor);
+
+/**
+ * Converts 4-bit grayscale pixels (2 pixels per byte, lower nibble first, refer to
+ * NanoCanvas4) to RGB 5-6-5 pixels. Output pixels are stored in big-endian order.
+ *
+ * @param dst destination buffer, must have space for count * 2 bytes
+ * @param src source 4-bit pixels
+ * @param count number of pixels to convert
+ */
+void lcd_convertGray4ToRgb16(uint8_t *dst, const uint8_t *src, lcduint_t count);
+
+/**
+ * @}
+ */
+
+#endif
@@ -192,6 +192,28 @@ public:
      */
     void drawBuffer1Fast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer);
 
+    /**
+     * Sends only those parts of 1-bit buffer, which differ from the content of front buffer,
+     * that is from the data, currently displayed. Each page is compared column by column,
+     * and separate block is started only for changed column spans. Front buffer is updated
+     * with sent data. This method has the same limitations as drawBuffer1Fast.
+     *
+     * @code{.cpp}
+     * NanoCanvas<128,64,1> canvas;
+     * uint8_t front[128*64/8] = {};  // display content after clear()
+     * ...
+     * display.drawBuffer1Diff(0, 0, 128, 64, canvas.getData(), front);
+     * @endcode
+     *
+     * @param x horizontal position in pixels
+     * @param y vertical position in pixels
+     * @param w width of bitmap in pixels
+     * @param h height of bitmap in pixels (must be divided by 8)
+     * @param buffer pointer to data, located in SRAM: each byte represents 8 vertical pixels.
+     * @param front pointer to buffer of the same size, holding content of the display area
+     */
+    void drawBuffer1Diff(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer, uint8_t *front);
+
     /**
      * Draws 4-bit bitmap, located in RAM, on the display
      * Each byte represents two pixels in 4-4 format:
@@ -737,7 +759,7 @@ class NanoDisplayOps16: public NanoDisplayBase<I>
 {
 public:
     /** number of bits per single pixel in buffer */
-    static const uint8_t BITS_PER_PIXEL = 1;
+    static const uint8_t BITS_PER_PIXEL = 16;
 
     using NanoDisplayBase<I>::NanoDisplayBase;
 
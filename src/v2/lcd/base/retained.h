@@ -0,0 +1,465 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file retained.h Retained mode display with dirty rectangles tracking
+ */
+
+#ifndef _LCDGFX_RETAINED_H_
+#define _LCDGFX_RETAINED_H_
+
+#include "canvas/rect.h"
+#include "canvas/canvas.h"
+
+/**
+ * @ingroup LCD_GENERIC_API
+ * @{
+ */
+
+#ifndef NRD_MAX_DIRTY_RECTS
+#define NRD_MAX_DIRTY_RECTS 8    ///< Maximum number of dirty rectangles. Can be defined outside the library
+#endif
+
+#if defined(__AVR__)
+
+#ifndef NRD_SCRATCH_SIZE
+#define NRD_SCRATCH_SIZE    64   ///< Size of buffer in bytes, used to send dirty areas. Can be defined outside the library
+#endif
+
+#else
+
+#ifndef NRD_SCRATCH_SIZE
+#define NRD_SCRATCH_SIZE    4096 ///< Size of buffer in bytes, used to send dirty areas. Can be defined outside the library
+#endif
+
+#endif
+
+#ifndef NRD_WINDOW_COST
+/** Cost of setting display window, expressed in pixels. Rectangles are merged if it is cheaper */
+#define NRD_WINDOW_COST     64
+#endif
+
+/**
+ * NanoRetainedDisplay draws all primitives to RAM mirror of the display and remembers
+ * changed areas. flush() merges changed areas and sends them to the display as minimal
+ * set of windows. This is useful for displays, which draw primitives directly,
+ * since each primitive requires separate window setup. Areas larger than
+ * NRD_SCRATCH_SIZE bytes are sent by several strips.
+ * C is full-screen canvas type (for example, NanoCanvas<320,240,16>), D is display type.
+ *
+ * @code{.cpp}
+ * DisplayILI9341_240x320x16_SPI display(3,{-1, 0, 1, 0, -1, -1});
+ * NanoRetainedDisplay<NanoCanvas<240,320,16>, DisplayILI9341_240x320x16_SPI> screen( display );
+ *
+ * screen.drawRect( 10, 10, 50, 50 );
+ * screen.printFixed( 0, 0, "Hello" );
+ * screen.flush();
+ * @endcode
+ */
+template <class C, class D>
+class NanoRetainedDisplay: public C
+{
+public:
+    /** Bits per pixel of the mirror */
+    static const uint8_t BPP = C::BITS_PER_PIXEL;
+
+    /**
+     * Creates retained mode wrapper for the display.
+     *
+     * @param display reference to display object
+     */
+    explicit NanoRetainedDisplay(D &display): C(), m_display( display )
+    {
+    }
+
+    /**
+     * Marks rectangle area for refreshing. The area is sent to the display on flush().
+     *
+     * @param rect rectangle area to refresh in display coordinates
+     */
+    void invalidate(const NanoRect &rect) __attribute__ ((noinline));
+
+    /**
+     * Marks the whole display for refreshing.
+     */
+    void invalidate()
+    {
+        invalidate( { {0, 0}, {(lcdint_t)this->m_w - 1, (lcdint_t)this->m_h - 1} } );
+    }
+
+    /**
+     * Sends changed areas to the display.
+     */
+    void flush() __attribute__ ((noinline));
+
+    /**
+     * Returns number of windows to be sent on flush()
+     */
+    uint8_t dirtyCount() const { return m_dirtyCount; }
+
+    /** @copydoc NanoCanvasOps::putPixel */
+    void putPixel(lcdint_t x, lcdint_t y)
+    {
+        C::putPixel( x, y );
+        mark( x, y, x, y );
+    }
+
+    /** @copydoc NanoCanvasOps::putPixel(const NanoPoint &) */
+    void putPixel(const NanoPoint &p)
+    {
+        putPixel( p.x, p.y );
+    }
+
+    /** @copydoc NanoCanvasOps::drawHLine */
+    void drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+    {
+        C::drawHLine( x1, y1, x2 );
+        mark( x1, y1, x2, y1 );
+    }
+
+    /** @copydoc NanoCanvasOps::drawVLine */
+    void drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
+    {
+        C::drawVLine( x1, y1, y2 );
+        mark( x1, y1, x1, y2 );
+    }
+
+    /** @copydoc NanoCanvasOps::drawLine */
+    void drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+    {
+        C::drawLine( x1, y1, x2, y2 );
+        mark( x1, y1, x2, y2 );
+    }
+
+    /** @copydoc NanoCanvasOps::drawLine(const NanoRect &) */
+    void drawLine(const NanoRect &rect)
+    {
+        drawLine( rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y );
+    }
+
+    /**
+     * @copydoc NanoCanvasOps::drawRect
+     * Each side is tracked separately, so the frame doesn't refresh its content.
+     */
+    void drawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+    {
+        drawHLine( x1, y1, x2 );
+        drawHLine( x1, y2, x2 );
+        drawVLine( x1, y1, y2 );
+        drawVLine( x2, y1, y2 );
+    }
+
+    /** @copydoc NanoCanvasOps::drawRect(const NanoRect &) */
+    void drawRect(const NanoRect &rect)
+    {
+        drawRect( rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y );
+    }
+
+    /** @copydoc NanoCanvasOps::fillRect */
+    void fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+    {
+        C::fillRect( x1, y1, x2, y2 );
+        mark( x1, y1, x2, y2 );
+    }
+
+    /** @copydoc NanoCanvasOps::fillRect(const NanoRect &) */
+    void fillRect(const NanoRect &rect)
+    {
+        fillRect( rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y );
+    }
+
+    /** @copydoc NanoCanvasOps::drawCircle */
+    void drawCircle(lcdint_t x, lcdint_t y, lcdint_t r)
+    {
+        C::drawCircle( x, y, r );
+        mark( x - r, y - r, x + r, y + r );
+    }
+
+    /** @copydoc NanoCanvasOps::fillCircle */
+    void fillCircle(lcdint_t x, lcdint_t y, lcdint_t r)
+    {
+        C::fillCircle( x, y, r );
+        mark( x - r, y - r, x + r, y + r );
+    }
+
+    /** @copydoc NanoCanvasOps::fillRoundRect */
+    void fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t r)
+    {
+        C::fillRoundRect( x1, y1, x2, y2, r );
+        mark( x1, y1, x2, y2 );
+    }
+
+    /** @copydoc NanoCanvasOps::fillTriangle */
+    void fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3)
+    {
+        C::fillTriangle( x1, y1, x2, y2, x3, y3 );
+        const NanoPoint points[3] = { {x1, y1}, {x2, y2}, {x3, y3} };
+        markPoints( points, 3 );
+    }
+
+    /** @copydoc NanoCanvasOps::fillPolygon */
+    void fillPolygon(const NanoPoint *points, uint8_t count)
+    {
+        C::fillPolygon( points, count );
+        markPoints( points, count );
+    }
+
+    /** @copydoc NanoCanvasOps::drawBitmap1 */
+    void drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+    {
+        C::drawBitmap1( x, y, w, h, bitmap );
+        mark( x, y, x + w - 1, y + h - 1 );
+    }
+
+    /** @copydoc NanoCanvasOps::drawBitmap8 */
+    void drawBitmap8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+    {
+        C::drawBitmap8( x, y, w, h, bitmap );
+        mark( x, y, x + w - 1, y + h - 1 );
+    }
+
+    /** @copydoc NanoCanvasOps::clear */
+    void clear()
+    {
+        C::clear();
+        invalidate();
+    }
+
+    /** @copydoc NanoCanvasOps::printChar */
+    uint8_t printChar(uint8_t c)
+    {
+        lcdint_t x = this->m_cursorX;
+        lcdint_t y = this->m_cursorY;
+        uint8_t result = C::printChar( c );
+        lcdint_t x2 = this->m_cursorY == y ? this->m_cursorX : this->offsetEnd().x;
+        mark( x, y, x2 + (this->m_fontStyle == STYLE_BOLD ? 1 : 0),
+              y + (lcdint_t)this->getFont().getHeader().height - 1 );
+        return result;
+    }
+
+    /** @copydoc NanoCanvasOps::write */
+    size_t write(uint8_t c)
+    {
+        if ( c == '\n' || c == '\r' )
+        {
+            return C::write( c );
+        }
+        return printChar( c );
+    }
+
+    /** @copydoc NanoCanvasOps::printFixed */
+    void printFixed(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style = STYLE_NORMAL)
+    {
+        this->m_fontStyle = style;
+        this->m_cursorX = xpos;
+        this->m_cursorY = y;
+        while (*ch)
+        {
+            write(*ch);
+            ch++;
+        }
+    }
+
+    /** @copydoc NanoCanvasOps::printFixedPgm */
+    void printFixedPgm(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style = STYLE_NORMAL)
+    {
+        this->m_fontStyle = style;
+        this->m_cursorX = xpos;
+        this->m_cursorY = y;
+        for (;;)
+        {
+            char c = pgm_read_byte(ch);
+            if (!c) break;
+            write(c);
+            ch++;
+        }
+    }
+
+private:
+    D &m_display;
+    uint8_t m_scratch[NRD_SCRATCH_SIZE];
+    NanoRect m_dirty[NRD_MAX_DIRTY_RECTS];
+    uint8_t m_dirtyCount = 0;
+
+    void mark(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+    {
+        if (x1 > x2) { lcdint_t t = x1; x1 = x2; x2 = t; }
+        if (y1 > y2) { lcdint_t t = y1; y1 = y2; y2 = t; }
+        markRect( { {x1, y1}, {x2, y2} } );
+    }
+
+    /* Primitives are drawn in offset terms and only inside of clip area */
+    void markRect(const NanoRect &area)
+    {
+        NanoRect rect = area;
+        rect.crop( this->clipRect() );
+        if ( rect.p1.x > rect.p2.x || rect.p1.y > rect.p2.y )
+        {
+            return;
+        }
+        invalidate( rect - this->offset );
+    }
+
+    void markPoints(const NanoPoint *points, uint8_t count)
+    {
+        if ( !count )
+        {
+            return;
+        }
+        NanoRect bounds = { points[0], points[0] };
+        for (uint8_t i = 1; i < count; i++)
+        {
+            if ( points[i].x < bounds.p1.x ) bounds.p1.x = points[i].x;
+            if ( points[i].y < bounds.p1.y ) bounds.p1.y = points[i].y;
+            if ( points[i].x > bounds.p2.x ) bounds.p2.x = points[i].x;
+            if ( points[i].y > bounds.p2.y ) bounds.p2.y = points[i].y;
+        }
+        markRect( bounds );
+    }
+
+    void sendArea(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h);
+
+    static uint32_t area(const NanoRect &rect)
+    {
+        return (uint32_t)rect.width() * (uint32_t)rect.height();
+    }
+
+    static NanoRect join(const NanoRect &a, const NanoRect &b)
+    {
+        return { { a.p1.x < b.p1.x ? a.p1.x : b.p1.x, a.p1.y < b.p1.y ? a.p1.y : b.p1.y },
+                 { a.p2.x > b.p2.x ? a.p2.x : b.p2.x, a.p2.y > b.p2.y ? a.p2.y : b.p2.y } };
+    }
+};
+
+template <class C, class D>
+void NanoRetainedDisplay<C,D>::invalidate(const NanoRect &region)
+{
+    NanoRect rect = region;
+    rect.crop( { {0, 0}, {(lcdint_t)this->m_w - 1, (lcdint_t)this->m_h - 1} } );
+    if ( rect.p1.x > rect.p2.x || rect.p1.y > rect.p2.y )
+    {
+        return;
+    }
+    /* Align area to the bytes of the mirror, so it can be copied to the scratch as is */
+    if ( BPP == 1 )
+    {
+        rect.p1.y &= ~7;
+        rect.p2.y |= 7;
+    }
+    else if ( BPP == 4 )
+    {
+        rect.p1.x &= ~1;
+        rect.p2.x |= 1;
+    }
+    /* Join new area with existing ones while it is cheaper than separate windows */
+    for (uint8_t i = 0; i < m_dirtyCount; )
+    {
+        NanoRect joined = join( m_dirty[i], rect );
+        if ( this->area( joined ) <= this->area( m_dirty[i] ) + this->area( rect ) + NRD_WINDOW_COST )
+        {
+            rect = joined;
+            m_dirty[i] = m_dirty[--m_dirtyCount];
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+    if ( m_dirtyCount == NRD_MAX_DIRTY_RECTS )
+    {
+        /* No free slots, so join with the area, which grows the least */
+        uint8_t best = 0;
+        uint32_t bestGrowth = 0xFFFFFFFF;
+        for (uint8_t i = 0; i < m_dirtyCount; i++)
+        {
+            uint32_t growth = this->area( join( m_dirty[i], rect ) ) - this->area( m_dirty[i] );
+            if ( growth < bestGrowth )
+            {
+                bestGrowth = growth;
+                best = i;
+            }
+        }
+        rect = join( m_dirty[best], rect );
+        m_dirty[best] = m_dirty[--m_dirtyCount];
+    }
+    m_dirty[m_dirtyCount++] = rect;
+}
+
+template <class C, class D>
+void NanoRetainedDisplay<C,D>::flush()
+{
+    /* Maximum width of the strip, which fits the scratch buffer. 1-bit areas *
+     * consist of pages, where single byte holds 8 rows of one column        */
+    const uint16_t maxW = BPP == 1 ? NRD_SCRATCH_SIZE : NRD_SCRATCH_SIZE * 8 / BPP;
+    for (uint8_t i = 0; i < m_dirtyCount; i++)
+    {
+        const NanoRect &rect = m_dirty[i];
+        uint16_t width = rect.width();
+        uint16_t height = rect.height();
+        for (uint16_t dx = 0; dx < width; dx += maxW)
+        {
+            uint16_t w = width - dx < maxW ? width - dx : maxW;
+            uint16_t maxH = BPP == 1 ? (NRD_SCRATCH_SIZE / w) << 3
+                                     : (uint32_t)NRD_SCRATCH_SIZE * 8 / ((uint32_t)w * BPP);
+            for (uint16_t dy = 0; dy < height; dy += maxH)
+            {
+                uint16_t h = height - dy < maxH ? height - dy : maxH;
+                sendArea( rect.p1.x + dx, rect.p1.y + dy, w, h );
+            }
+        }
+    }
+    m_dirtyCount = 0;
+}
+
+template <class C, class D>
+void NanoRetainedDisplay<C,D>::sendArea(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h)
+{
+    const uint8_t *src = this->getData();
+    uint8_t *dst = m_scratch;
+    /* Canvas object clears the buffer on initialization, so create it first */
+    NanoCanvasOps<BPP> window( w, h, dst );
+    /* Mirror rows are not contiguous, so the area is copied to the scratch *
+     * buffer to be sent by single drawBuffer call                          */
+    if ( BPP == 1 )
+    {
+        for (lcduint_t page = 0; page < (h >> 3); page++)
+        {
+            memcpy( &dst[page * w], &src[((y >> 3) + page) * this->m_w + x], w );
+        }
+    }
+    else
+    {
+        uint32_t stride = (uint32_t)this->m_w * BPP / 8;
+        uint32_t len = (uint32_t)w * BPP / 8;
+        for (lcduint_t row = 0; row < h; row++)
+        {
+            memcpy( &dst[row * len], &src[(y + row) * stride + (uint32_t)x * BPP / 8], len );
+        }
+    }
+    m_display.drawCanvas( x, y, window );
+}
+
+/**
+ * @}
+ */
+
+#endif
@@ -23,6 +23,7 @@
 */
 
 #include "lcd_hal/io.h"
+#include "color_convert.h"
 
 #if 0
 void    ssd1306_setRgbColor16(uint8_t r, uint8_t g, uint8_t b)
@@ -178,11 +179,9 @@ template <class I>
 void NanoDisplayOps16<I>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
     this->m_intf.startBlock(x1, y1, 0);
-    while (x1 < x2)
+    if (x1 < x2)
     {
-        this->m_intf.send( this->m_color >> 8 );
-        this->m_intf.send( this->m_color & 0xFF );
-        x1++;
+        lcd_sendRepeat( this->m_intf, this->m_color, x2 - x1 );
     }
     this->m_intf.endBlock();
 }
@@ -191,11 +190,9 @@ template <class I>
 void NanoDisplayOps16<I>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
     this->m_intf.startBlock(x1, y1, 1);
-    while (y1<=y2)
+    if (y1 <= y2)
     {
-        this->m_intf.send( this->m_color >> 8 );
-        this->m_intf.send( this->m_color & 0xFF );
-        y1++;
+        lcd_sendRepeat( this->m_intf, this->m_color, y2 - y1 + 1 );
     }
     this->m_intf.endBlock();
 }
@@ -212,12 +209,8 @@ void NanoDisplayOps16<I>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
     this->m_intf.startBlock(x1, y1, x2 - x1 + 1);
-    uint16_t count = (x2 - x1 + 1) * (y2 - y1 + 1);
-    while (count--)
-    {
-        this->m_intf.send( this->m_color >> 8 );
-        this->m_intf.send( this->m_color & 0xFF );
-    }
+    uint32_t count = (uint32_t)(x2 - x1 + 1) * (uint32_t)(y2 - y1 + 1);
+    lcd_sendRepeat( this->m_intf, this->m_color, count );
     this->m_intf.endBlock();
 }
 
@@ -226,11 +219,7 @@ void NanoDisplayOps16<I>::fill(uint16_t color)
 {
     this->m_intf.startBlock(0, 0, 0);
     uint32_t count = (uint32_t)this->m_w * (uint32_t)this->m_h;
-    while (count--)
-    {
-        this->m_intf.send( color >> 8 );
-        this->m_intf.send( color & 0xFF );
-    }
+    lcd_sendRepeat( this->m_intf, color, count );
     this->m_intf.endBlock();
 }
 
@@ -322,36 +311,20 @@ void NanoDisplayOps16<I>::drawBitmap16(lcdint_t x, lcdint_t y, lcduint_t w, lcdu
 template <class I>
 void NanoDisplayOps16<I>::drawBuffer1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *buffer)
 {
-    uint8_t bit = 1;
-    uint16_t blackColor = this->m_bgColor;
-    uint16_t color = this->m_color;
+    uint8_t row[LCD_CONVERT_CHUNK_PIXELS * 2];
     this->m_intf.startBlock(xpos, ypos, w);
-    while (h--)
+    for (lcduint_t j = 0; j < h; j++)
     {
+        /* Each page of 1-bit buffer contains 8 rows */
+        const uint8_t *src = buffer + (j >> 3) * w;
         lcduint_t wx = w;
-        while ( wx-- )
-        {
-            uint8_t data = *buffer;
-            if ( data & bit )
-            {
-                this->m_intf.send( color >> 8 );
-                this->m_intf.send( color & 0xFF );
-            }
-            else
-            {
-                this->m_intf.send( blackColor >> 8 );
-                this->m_intf.send( blackColor & 0xFF );
-            }
-            buffer++;
-        }
-        bit <<= 1;
-        if ( bit == 0 )
+        while ( wx )
         {
-            bit = 1;
-        }
-        else
-        {
-            buffer -= w;
+            lcduint_t size = wx > LCD_CONVERT_CHUNK_PIXELS ? LCD_CONVERT_CHUNK_PIXELS : wx;
+            lcd_convertMonoToRgb16( row, src, 1 << (j & 0x07), size, this->m_color, this->m_bgColor );
+            this->m_intf.sendBuffer( row, size * 2 );
+            src += size;
+            wx -= size;
         }
     }
     this->m_intf.endBlock();
@@ -366,20 +339,34 @@ void NanoDisplayOps16<I>::drawBuffer1Fast(lcdint_t x, lcdint_t y, lcduint_t w, l
 template <class I>
 void NanoDisplayOps16<I>::drawBuffer4(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer)
 {
-    // NOT IMPLEMENTED
+    uint8_t row[LCD_CONVERT_CHUNK_PIXELS * 2];
+    this->m_intf.startBlock(x, y, w);
+    uint32_t count = (uint32_t)w * (uint32_t)h;
+    while (count)
+    {
+        /* Chunk size is even, so each chunk starts at byte boundary */
+        lcduint_t size = count > LCD_CONVERT_CHUNK_PIXELS ? LCD_CONVERT_CHUNK_PIXELS : count;
+        lcd_convertGray4ToRgb16( row, buffer, size );
+        this->m_intf.sendBuffer( row, size * 2 );
+        buffer += size / 2;
+        count -= size;
+    }
+    this->m_intf.endBlock();
 }
 
 template <class I>
 void NanoDisplayOps16<I>::drawBuffer8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer)
 {
+    uint8_t row[LCD_CONVERT_CHUNK_PIXELS * 2];
     this->m_intf.startBlock(x, y, w);
-    uint32_t count = (w) * (h);
-    while (count--)
+    uint32_t count = (uint32_t)w * (uint32_t)h;
+    while (count)
     {
-        uint16_t color = RGB8_TO_RGB16((*buffer));
-        this->m_intf.send( color >> 8 );
-        this->m_intf.send( color & 0xFF );
-        buffer++;
+        lcduint_t size = count > LCD_CONVERT_CHUNK_PIXELS ? LCD_CONVERT_CHUNK_PIXELS : count;
+        lcd_convertRgb8ToRgb16( row, buffer, size );
+        this->m_intf.sendBuffer( row, size * 2 );
+        buffer += size;
+        count -= size;
     }
     this->m_intf.endBlock();
 }
@@ -388,12 +375,14 @@ template <class I>
 void NanoDisplayOps16<I>::drawBuffer16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer)
 {
     this->m_intf.startBlock(x, y, w);
-    uint32_t count = (w) * (h);
-    while (count--)
+    uint32_t count = (w) * (h) * 2;
+    while (count)
     {
-        this->m_intf.send( buffer[0] );
-        this->m_intf.send( buffer[1] );
-        buffer += 2;
+        /* sendBuffer() accepts up to 64KiB at once, while full-screen buffers can be larger */
+        uint16_t size = count > 0x8000 ? 0x8000 : count;
+        this->m_intf.sendBuffer( buffer, size );
+        buffer += size;
+        count -= size;
     }
     this->m_intf.endBlock();
 }
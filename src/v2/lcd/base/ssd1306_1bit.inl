@@ -684,6 +684,43 @@ void NanoDisplayOps1<I>::drawBuffer1Fast(lcdint_t x, lcdint_t y, lcduint_t w, lc
     this->m_intf.endBlock();
 }
 
+template <class I>
+void NanoDisplayOps1<I>::drawBuffer1Diff(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                                         const uint8_t *buf, uint8_t *front)
+{
+    /* Unchanged columns between two spans are sent, if it is cheaper than new block */
+    const lcduint_t maxGap = 8;
+    for(lcduint_t page = 0; page < (h >> 3); page++)
+    {
+        lcduint_t col = 0;
+        for(;;)
+        {
+            while ( col < w && buf[col] == front[col] ) col++;
+            if ( col >= w )
+            {
+                break;
+            }
+            lcduint_t start = col;
+            lcduint_t end = col;
+            while ( col < w && col - end < maxGap )
+            {
+                if ( buf[col] != front[col] )
+                {
+                    end = col + 1;
+                }
+                col++;
+            }
+            this->m_intf.startBlock(x + start, (y >> 3) + page, end - start);
+            this->m_intf.sendBuffer( &buf[start], end - start );
+            this->m_intf.endBlock();
+            memcpy( &front[start], &buf[start], end - start );
+            col = end;
+        }
+        buf += w;
+        front += w;
+    }
+}
+
 template <class I>
 void NanoDisplayOps1<I>::drawBuffer4(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buffer)
 {
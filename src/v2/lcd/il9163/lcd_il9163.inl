@@ -35,6 +35,7 @@
 template <class I>
 void InterfaceIL9163<I>::startBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
+    lcd_notifyStartBlock( static_cast<I &>(*this) );
     lcduint_t rx = w ? (x + w - 1) : (m_base.width() - 1);
     this->start();
     setDataMode(0);
@@ -74,6 +75,7 @@ void InterfaceIL9163<I>::endBlock()
 template <class I>
 void InterfaceIL9163<I>::setDataMode(uint8_t mode)
 {
+    lcd_notifyDataMode( static_cast<I &>(*this), mode );
     if ( m_dc >= 0 )
     {
         lcd_gpioWrite( m_dc, mode ? LCD_HIGH : LCD_LOW );
@@ -73,6 +73,53 @@ public:
      * @param data - byte to send
      */
     virtual void send(uint8_t data) = 0;
+
+    /**
+     * Sends bytes to display device. Override it if display device can send
+     * block of data faster than byte by byte.
+     * @param buffer - bytes to send
+     * @param size - number of bytes to send
+     */
+    virtual void sendBuffer(const uint8_t *buffer, uint16_t size)
+    {
+        while (size--)
+        {
+            send( *buffer );
+            buffer++;
+        }
+    }
+
+    /**
+     * Sends 16-bit word to display device specified number of times,
+     * most significant byte first. Override it if display device can send
+     * repeated data faster than byte by byte.
+     * @param pattern - 16-bit word to send
+     * @param count - number of times to send the word
+     */
+    virtual void sendRepeat(uint16_t pattern, uint32_t count)
+    {
+        while (count--)
+        {
+            send( pattern >> 8 );
+            send( pattern & 0xFF );
+        }
+    }
+
+    /**
+     * Sends array of 16-bit words to display device, most significant byte first.
+     * Override it if display device can send block of data faster than byte by byte.
+     * @param pixels - 16-bit words to send
+     * @param count - number of words to send
+     */
+    virtual void sendPixels16(const uint16_t *pixels, uint32_t count)
+    {
+        while (count--)
+        {
+            send( *pixels >> 8 );
+            send( *pixels & 0xFF );
+            pixels++;
+        }
+    }
 };
 
 
@@ -136,6 +183,36 @@ public:
         m_intf.send(data);
     }
 
+    /**
+     * Sends bytes to display device
+     * @param buffer - bytes to send
+     * @param size - number of bytes to send
+     */
+    void sendBuffer(const uint8_t *buffer, uint16_t size)
+    {
+        m_intf.sendBuffer(buffer, size);
+    }
+
+    /**
+     * Sends 16-bit word to display device specified number of times
+     * @param pattern - 16-bit word to send
+     * @param count - number of times to send the word
+     */
+    void sendRepeat(uint16_t pattern, uint32_t count)
+    {
+        m_intf.sendRepeat(pattern, count);
+    }
+
+    /**
+     * Sends array of 16-bit words to display device
+     * @param pixels - 16-bit words to send
+     * @param count - number of words to send
+     */
+    void sendPixels16(const uint16_t *pixels, uint32_t count)
+    {
+        m_intf.sendPixels16(pixels, count);
+    }
+
 private:
     DisplayInterface &m_intf; ///< basic display communication interface
 };
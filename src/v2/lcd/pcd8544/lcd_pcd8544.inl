@@ -35,6 +35,7 @@
 template <class I>
 void InterfacePCD8544<I>::startBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
+    lcd_notifyStartBlock( static_cast<I &>(*this) );
     m_width = w;
     m_column = x;
     m_page = y;
@@ -68,6 +69,7 @@ void InterfacePCD8544<I>::endBlock()
 template <class I>
 void InterfacePCD8544<I>::setDataMode(uint8_t mode)
 {
+    lcd_notifyDataMode( static_cast<I &>(*this), mode );
     if ( m_dc >= 0 )
     {
         lcd_gpioWrite( m_dc, mode ? LCD_HIGH : LCD_LOW );
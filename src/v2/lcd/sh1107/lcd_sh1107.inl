@@ -35,6 +35,7 @@
 template <class I>
 void InterfaceSH1107<I>::startBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
+    lcd_notifyStartBlock( static_cast<I &>(*this) );
     m_column = x;
     m_page = y;
     commandStart();
@@ -69,6 +70,7 @@ void InterfaceSH1107<I>::endBlock()
 template <class I>
 void InterfaceSH1107<I>::setDataMode(uint8_t mode)
 {
+    lcd_notifyDataMode( static_cast<I &>(*this), mode );
     if ( m_dc >= 0 )
     {
         lcd_gpioWrite( m_dc, mode ? LCD_HIGH : LCD_LOW );
@@ -35,6 +35,7 @@
 template <class I>
 void InterfaceSSD1351<I>::startBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
+    lcd_notifyStartBlock( static_cast<I &>(*this) );
     lcduint_t rx = w ? (x + w - 1) : (m_base.width() - 1);
     commandStart();
     this->send((m_rotation & 0x01) ? 0x75: 0x15);
@@ -75,6 +76,7 @@ void InterfaceSSD1351<I>::endBlock()
 template <class I>
 void InterfaceSSD1351<I>::setDataMode(uint8_t mode)
 {
+    lcd_notifyDataMode( static_cast<I &>(*this), mode );
     if ( m_dc >= 0 )
     {
         lcd_gpioWrite( m_dc, mode ? LCD_HIGH : LCD_LOW );
@@ -245,9 +245,9 @@ protected:
 /**
  * Base class for NanoEngine.
  */
-template<class C, class D>
+template<class C, class D, class R>
 class NanoEngine: public NanoEngineCore,
-                  public NanoEngineTiler<C,D>
+                  public NanoEngineTiler<C,D,R>
 {
 public:
     /**
@@ -279,34 +279,34 @@ public:
 protected:
 };
 
-template<class C, class D>
-NanoEngine<C,D>::NanoEngine( D & display)
-    : NanoEngineCore(), NanoEngineTiler<C,D>(display)
+template<class C, class D, class R>
+NanoEngine<C,D,R>::NanoEngine( D & display)
+    : NanoEngineCore(), NanoEngineTiler<C,D,R>(display)
 {
 }
 
-template<class C, class D>
-void NanoEngine<C,D>::display()
+template<class C, class D, class R>
+void NanoEngine<C,D,R>::display()
 {
     resetButtonsCache();
     m_lastFrameTs = lcd_millis();
-    NanoEngineTiler<C,D>::displayBuffer();
+    NanoEngineTiler<C,D,R>::displayBuffer();
     m_cpuLoad = ((lcd_millis() - m_lastFrameTs)*100)/m_frameDurationMs;
 }
 
-template<class C, class D>
-void NanoEngine<C,D>::begin()
+template<class C, class D, class R>
+void NanoEngine<C,D,R>::begin()
 {
     NanoEngineCore::begin();
 }
 
-template<class C, class D>
-void NanoEngine<C,D>::notify(const char *str)
+template<class C, class D, class R>
+void NanoEngine<C,D,R>::notify(const char *str)
 {
-    NanoEngineTiler<C,D>::displayPopup(str);
+    NanoEngineTiler<C,D,R>::displayPopup(str);
     lcd_delay(1000);
     m_lastFrameTs = lcd_millis();
-    NanoEngineTiler<C,D>::refresh();
+    NanoEngineTiler<C,D,R>::refresh();
 }
 
 /**
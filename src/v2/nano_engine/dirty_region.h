@@ -0,0 +1,274 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file dirty_region.h Structures, tracking NanoEngine tiles to be refreshed
+ */
+
+#ifndef _NANO_ENGINE_DIRTY_REGION_H_
+#define _NANO_ENGINE_DIRTY_REGION_H_
+
+#include "canvas/rect.h"
+
+/**
+ * @ingroup NANO_ENGINE_API_V2
+ * @{
+ */
+
+#if defined(__AVR__)
+
+#ifndef NE_MAX_TILE_ROWS
+#define NE_MAX_TILE_ROWS 20      ///< Maximum tile rows supported. Can be defined outside the library
+#endif
+
+#ifndef NE_MAX_TILE_COLS
+#define NE_MAX_TILE_COLS 16      ///< Maximum tile columns supported. Can be defined outside the library
+#endif
+
+#else
+
+#ifndef NE_MAX_TILE_ROWS
+#define NE_MAX_TILE_ROWS 40      ///< Maximum tile rows supported. Can be defined outside the library
+#endif
+
+#ifndef NE_MAX_TILE_COLS
+#define NE_MAX_TILE_COLS 40      ///< Maximum tile columns supported. Can be defined outside the library
+#endif
+
+#endif
+
+/**
+ * Bitset of tiles to refresh. This is default dirty region of NanoEngine.
+ * Each tile takes single bit, so 320x240 display with 8x8 tiles (40x30 tiles)
+ * requires 150 bytes. If marked block doesn't fit COLS x ROWS area, the whole
+ * screen is refreshed, so use canvas with bigger tiles or increase NE_MAX_TILE_COLS
+ * and NE_MAX_TILE_ROWS for large displays to keep partial updates.
+ *
+ * @tparam COLS maximum number of tile columns
+ * @tparam ROWS maximum number of tile rows
+ */
+template <uint16_t COLS, uint16_t ROWS>
+class NanoDirtyTiles
+{
+public:
+    /**
+     * Marks all tiles as not requiring refresh
+     */
+    void clear() { memset(m_bits, 0, sizeof(m_bits)); m_all = false; }
+
+    /**
+     * Marks all tiles for refresh, including tiles outside of supported area
+     */
+    void markAll() { m_all = true; }
+
+    /**
+     * Marks block of tiles for refresh. If the block has tiles outside of
+     * supported area, all tiles are marked for refresh.
+     *
+     * @param col1 left column
+     * @param row1 top row
+     * @param col2 right column
+     * @param row2 bottom row
+     */
+    void mark(lcdint_t col1, lcdint_t row1, lcdint_t col2, lcdint_t row2)
+    {
+        if ((col2 >= (lcdint_t)COLS) || (row2 >= (lcdint_t)ROWS))
+        {
+            /* Bitset cannot hold these tiles, and they must not be lost */
+            m_all = true;
+            return;
+        }
+        if (col1 < 0) col1 = 0;
+        if (row1 < 0) row1 = 0;
+        for (lcdint_t row = row1; row <= row2; row++)
+        {
+            for (lcdint_t col = col1; col <= col2; col++)
+            {
+                uint16_t index = row * COLS + col;
+                m_bits[index >> 3] |= (1 << (index & 0x07));
+            }
+        }
+    }
+
+    /**
+     * Returns true if tile needs to be refreshed
+     *
+     * @param col tile column
+     * @param row tile row
+     */
+    bool contains(lcdint_t col, lcdint_t row) const
+    {
+        if ((col < 0) || (row < 0))
+        {
+            return false;
+        }
+        if (m_all)
+        {
+            return true;
+        }
+        if ((col >= (lcdint_t)COLS) || (row >= (lcdint_t)ROWS))
+        {
+            return false;
+        }
+        uint16_t index = row * COLS + col;
+        return m_bits[index >> 3] & (1 << (index & 0x07));
+    }
+
+private:
+    uint8_t m_bits[(COLS * ROWS + 7) / 8]{};
+    bool m_all = false;
+};
+
+/**
+ * List of tile rectangles to refresh. It is suitable for sparse updates on large
+ * displays: memory consumption doesn't depend on display size, and there is no
+ * limit on number of tile columns and rows. Each marked block is joined with
+ * existing rectangle, if this doesn't add extra tiles. When the list is full,
+ * new block is merged with the rectangle, which grows least of all.
+ *
+ * @tparam N maximum number of rectangles in the list
+ */
+template <uint8_t N>
+class NanoDirtyRects
+{
+public:
+    /**
+     * Marks all tiles as not requiring refresh
+     */
+    void clear() { m_count = 0; m_all = false; }
+
+    /**
+     * Marks all tiles for refresh
+     */
+    void markAll() { m_count = 0; m_all = true; }
+
+    /**
+     * Marks block of tiles for refresh
+     *
+     * @param col1 left column
+     * @param row1 top row
+     * @param col2 right column
+     * @param row2 bottom row
+     */
+    void mark(lcdint_t col1, lcdint_t row1, lcdint_t col2, lcdint_t row2)
+    {
+        if ( m_all || col1 > col2 || row1 > row2 )
+        {
+            return;
+        }
+        NanoRect rect = { {col1, row1}, {col2, row2} };
+        uint8_t i = 0;
+        while ( i < m_count )
+        {
+            if ( m_rects[i].contains( rect ) )
+            {
+                return;
+            }
+            NanoRect joined = join( m_rects[i], rect );
+            if ( area( joined ) <= area( m_rects[i] ) + area( rect ) - overlap( m_rects[i], rect ) )
+            {
+                /* Joined rectangle doesn't include extra tiles, so replace *
+                 * both with it and check the others again                  */
+                rect = joined;
+                m_rects[i] = m_rects[--m_count];
+                i = 0;
+                continue;
+            }
+            i++;
+        }
+        if ( m_count < N )
+        {
+            m_rects[m_count++] = rect;
+            return;
+        }
+        uint8_t best = 0;
+        int32_t bestGrowth = area( join( m_rects[0], rect ) ) - area( m_rects[0] );
+        for (i = 1; i < m_count; i++)
+        {
+            int32_t growth = area( join( m_rects[i], rect ) ) - area( m_rects[i] );
+            if ( growth < bestGrowth )
+            {
+                best = i;
+                bestGrowth = growth;
+            }
+        }
+        m_rects[best] = join( m_rects[best], rect );
+    }
+
+    /**
+     * Returns true if tile needs to be refreshed
+     *
+     * @param col tile column
+     * @param row tile row
+     */
+    bool contains(lcdint_t col, lcdint_t row) const
+    {
+        if ( m_all )
+        {
+            return true;
+        }
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            if ( m_rects[i].collision( (NanoPoint){ col, row } ) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Returns number of rectangles in the list */
+    uint8_t count() const { return m_count; }
+
+    /** Returns rectangle by index, coordinates are in tiles */
+    const NanoRect &rect(uint8_t index) const { return m_rects[index]; }
+
+private:
+    NanoRect m_rects[N];
+    uint8_t m_count = 0;
+    bool m_all = false;
+
+    static NanoRect join(const NanoRect &a, const NanoRect &b)
+    {
+        return { { min(a.p1.x, b.p1.x), min(a.p1.y, b.p1.y) },
+                 { max(a.p2.x, b.p2.x), max(a.p2.y, b.p2.y) } };
+    }
+
+    static int32_t area(const NanoRect &r)
+    {
+        return (int32_t)r.width() * r.height();
+    }
+
+    static int32_t overlap(const NanoRect &a, const NanoRect &b)
+    {
+        lcdint_t w = min(a.p2.x, b.p2.x) - max(a.p1.x, b.p1.x) + 1;
+        lcdint_t h = min(a.p2.y, b.p2.y) - max(a.p1.y, b.p1.y) + 1;
+        return (w > 0 && h > 0) ? (int32_t)w * h : 0;
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
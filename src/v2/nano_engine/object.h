@@ -83,6 +83,7 @@ public:
      */
     void refresh() override
     {
+        this->setBounds( m_rect );
         if (this->hasTiler())
         {
              this->getTiler().refreshWorld( m_rect );
@@ -151,6 +152,7 @@ public:
     {
         m_rect.p2.x = m_rect.p1.x + size.x - 1;
         m_rect.p2.y = m_rect.p1.y + size.y - 1;
+        updateBounds();
     }
 
     /**
@@ -161,6 +163,7 @@ public:
         m_rect = (NanoRect){ p,
                    (NanoPoint){ (lcdint_t)(p.x + m_rect.p2.x - m_rect.p1.x),
                                 (lcdint_t)(p.y + m_rect.p2.y - m_rect.p1.y) } };
+        updateBounds();
     }
 
     /**
@@ -227,6 +230,15 @@ public:
 protected:
     /** Rectangle area occupied by the object */
     NanoRect       m_rect;
+
+    /** Updates spatial index of NanoEngine, if the object is already indexed */
+    void updateBounds()
+    {
+        if ( this->hasBounds() )
+        {
+            this->setBounds( m_rect );
+        }
+    }
 };
 
 template<class T>
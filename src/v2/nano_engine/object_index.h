@@ -0,0 +1,329 @@
+/*
+    MIT License
+
+    Copyright (c) 2018-2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file object_index.h Spatial index of NanoEngine objects
+ */
+
+#ifndef _NANO_ENGINE_OBJECT_INDEX_H_
+#define _NANO_ENGINE_OBJECT_INDEX_H_
+
+#include "canvas/rect.h"
+
+/**
+ * @ingroup NANO_ENGINE_API_V2
+ * @{
+ */
+
+#if defined(__AVR__)
+
+#ifndef NE_MAX_DRAW_OBJECTS
+#define NE_MAX_DRAW_OBJECTS 8    ///< Maximum objects, drawn in single tile via index. Can be defined outside the library
+#endif
+
+#else
+
+#ifndef NE_MAX_DRAW_OBJECTS
+#define NE_MAX_DRAW_OBJECTS 64   ///< Maximum objects, drawn in single tile via index. Can be defined outside the library
+#endif
+
+#endif
+
+#ifndef NE_INDEX_MAX_CELLS
+#define NE_INDEX_MAX_CELLS  8    ///< Objects, covering more grid cells, are drawn in every tile
+#endif
+
+template<class T>
+class NanoEngineObject;
+
+/**
+ * Spatial index of NanoEngine objects. The world is divided into square cells
+ * of the same size, and each object, bound to NanoEngine, is registered in all
+ * cells it overlaps. Cells are hashed to fixed number of buckets, so the index
+ * doesn't depend on world size. Objects without known area (for example, object
+ * lists and menus) and objects, covering more than NE_INDEX_MAX_CELLS cells,
+ * are drawn for every tile.
+ * If there is no free entries left, or too many objects overlap the tile, the engine
+ * walks the whole objects list as usual, so the index never affects the result.
+ * Use NanoObjectGrid to allocate the index.
+ *
+ * @tparam T type of NanoEngine tiler (NanoEngine<>::TilerT)
+ */
+template<class T>
+class NanoObjectIndex
+{
+public:
+    /** Type of objects, tracked by the index */
+    typedef NanoEngineObject<T> ObjectT;
+
+    /**
+     * Adds object to the index.
+     * @param object object to add
+     */
+    void add(ObjectT &object)
+    {
+        remove( object );
+        if ( !object.m_bounded )
+        {
+            insertEntry( object, 0 );
+            return;
+        }
+        lcdint_t cx1 = object.m_bounds.p1.x >> m_cellShift;
+        lcdint_t cy1 = object.m_bounds.p1.y >> m_cellShift;
+        lcdint_t cx2 = object.m_bounds.p2.x >> m_cellShift;
+        lcdint_t cy2 = object.m_bounds.p2.y >> m_cellShift;
+        if ( (uint32_t)(cx2 - cx1 + 1) * (uint32_t)(cy2 - cy1 + 1) > NE_INDEX_MAX_CELLS )
+        {
+            insertEntry( object, 0 );
+            return;
+        }
+        for (lcdint_t cy = cy1; cy <= cy2; cy++)
+        {
+            for (lcdint_t cx = cx1; cx <= cx2; cx++)
+            {
+                insertEntry( object, bucket( cx, cy ) );
+            }
+        }
+    }
+
+    /**
+     * Removes object from the index.
+     * @param object object to remove
+     */
+    void remove(ObjectT &object)
+    {
+        uint16_t index = object.m_entry;
+        while ( index != NONE )
+        {
+            Entry &entry = m_entries[index];
+            uint16_t *link = &m_buckets[entry.bucket];
+            while ( *link != index )
+            {
+                link = &m_entries[*link].next;
+            }
+            *link = entry.next;
+            uint16_t nextOwn = entry.nextOwn;
+            entry.next = m_free;
+            m_free = index;
+            index = nextOwn;
+        }
+        object.m_entry = NONE;
+    }
+
+    /**
+     * Returns true if some objects were not added to the index due to lack of entries.
+     * Overflow flag is cleared by clear().
+     */
+    bool overflow() const { return m_overflow; }
+
+    /**
+     * Removes all objects from the index
+     */
+    void clear()
+    {
+        for (uint8_t i = 0; i <= m_bucketCount; i++)
+        {
+            m_buckets[i] = NONE;
+        }
+        m_free = NONE;
+        for (uint16_t i = m_entryCount; i > 0; i--)
+        {
+            m_entries[i - 1].next = m_free;
+            m_free = i - 1;
+        }
+        m_overflow = false;
+    }
+
+    /**
+     * Finds objects, which can overlap specified area, in the order of drawing.
+     * Objects must have valid drawing order (see NanoEngineObject).
+     *
+     * @param area area in the same coordinates, which objects use
+     * @param objects array for found objects
+     * @param maxCount size of objects array
+     * @return number of found objects, or -1 if array is too small
+     */
+    int16_t find(const NanoRect &area, ObjectT **objects, uint16_t maxCount) const
+    {
+        uint16_t count = 0;
+        if ( !collect( m_buckets[0], area, objects, maxCount, count ) )
+        {
+            return -1;
+        }
+        lcdint_t cx1 = area.p1.x >> m_cellShift;
+        lcdint_t cy1 = area.p1.y >> m_cellShift;
+        lcdint_t cx2 = area.p2.x >> m_cellShift;
+        lcdint_t cy2 = area.p2.y >> m_cellShift;
+        for (lcdint_t cy = cy1; cy <= cy2; cy++)
+        {
+            for (lcdint_t cx = cx1; cx <= cx2; cx++)
+            {
+                if ( !collect( m_buckets[bucket( cx, cy )], area, objects, maxCount, count ) )
+                {
+                    return -1;
+                }
+            }
+        }
+        /* Restore Z-order: there are few objects per tile, so insertion sort is enough */
+        for (uint16_t i = 1; i < count; i++)
+        {
+            ObjectT *object = objects[i];
+            uint16_t j = i;
+            while ( j > 0 && objects[j - 1]->m_order > object->m_order )
+            {
+                objects[j] = objects[j - 1];
+                j--;
+            }
+            objects[j] = object;
+        }
+        return count;
+    }
+
+protected:
+    /**
+     * Initializes index over user-provided arrays
+     *
+     * @param buckets array of bucketCount + 1 elements
+     * @param bucketCount number of hash buckets
+     * @param entries array of entryCount elements
+     * @param entryCount number of entries
+     * @param cellShift size of grid cell as power of 2, for example 4 means 16x16 pixels
+     */
+    NanoObjectIndex(uint16_t *buckets, uint8_t bucketCount, void *entries, uint16_t entryCount, uint8_t cellShift)
+        : m_buckets( buckets )
+        , m_bucketCount( bucketCount )
+        , m_entries( static_cast<Entry *>(entries) )
+        , m_entryCount( entryCount )
+        , m_cellShift( cellShift )
+    {
+        clear();
+    }
+
+public:
+    /** Single registration of the object in the bucket */
+    typedef struct
+    {
+        ObjectT *object;   ///< registered object
+        uint16_t next;     ///< next entry in the bucket or free list
+        uint16_t nextOwn;  ///< next entry of the same object
+        uint8_t bucket;    ///< bucket, which the entry belongs to
+    } Entry;
+
+    /** Index of absent entry */
+    static const uint16_t NONE = 0xFFFF;
+
+private:
+    /** Bucket 0 holds objects, drawn for all tiles. Other buckets hold cells */
+    uint16_t *m_buckets;
+    uint8_t m_bucketCount;
+    Entry *m_entries;
+    uint16_t m_entryCount;
+    uint8_t m_cellShift;
+    uint16_t m_free = NONE;
+    bool m_overflow = false;
+
+    uint8_t bucket(lcdint_t cx, lcdint_t cy) const
+    {
+        return 1 + (uint16_t)((uint16_t)cx * 31u + (uint16_t)cy * 17u) % m_bucketCount;
+    }
+
+    void insertEntry(ObjectT &object, uint8_t bucket)
+    {
+        if ( m_free == NONE )
+        {
+            m_overflow = true;
+            return;
+        }
+        uint16_t index = m_free;
+        Entry &entry = m_entries[index];
+        m_free = entry.next;
+        entry.object = &object;
+        entry.bucket = bucket;
+        entry.next = m_buckets[bucket];
+        m_buckets[bucket] = index;
+        entry.nextOwn = object.m_entry;
+        object.m_entry = index;
+    }
+
+    bool collect(uint16_t index, const NanoRect &area, ObjectT **objects,
+                 uint16_t maxCount, uint16_t &count) const
+    {
+        for (; index != NONE; index = m_entries[index].next)
+        {
+            ObjectT *object = m_entries[index].object;
+            if ( object->m_bounded &&
+                 ( object->m_bounds.p2.x < area.p1.x || object->m_bounds.p1.x > area.p2.x ||
+                   object->m_bounds.p2.y < area.p1.y || object->m_bounds.p1.y > area.p2.y ) )
+            {
+                continue;
+            }
+            uint16_t i = 0;
+            while ( i < count && objects[i] != object ) i++;
+            if ( i < count )
+            {
+                continue;
+            }
+            if ( count >= maxCount )
+            {
+                return false;
+            }
+            objects[count++] = object;
+        }
+        return true;
+    }
+};
+
+/**
+ * Spatial index of NanoEngine objects with static storage.
+ * Each object takes one entry per grid cell it overlaps, and objects
+ * without known area take one entry.
+ *
+ * @tparam T type of NanoEngine tiler (NanoEngine<>::TilerT)
+ * @tparam BUCKETS number of hash buckets for grid cells [1-254]
+ * @tparam ENTRIES number of entries
+ */
+template<class T, uint8_t BUCKETS, uint16_t ENTRIES>
+class NanoObjectGrid: public NanoObjectIndex<T>
+{
+public:
+    /**
+     * Creates empty index
+     *
+     * @param cellShift size of grid cell as power of 2, for example 4 means 16x16 pixels.
+     *        Good choice is the size of engine tile.
+     */
+    explicit NanoObjectGrid(uint8_t cellShift = 4)
+        : NanoObjectIndex<T>( m_bucketsData, BUCKETS, m_entriesData, ENTRIES, cellShift )
+    {
+    }
+
+private:
+    uint16_t m_bucketsData[BUCKETS + 1];
+    typename NanoObjectIndex<T>::Entry m_entriesData[ENTRIES];
+};
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,126 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "profiler.h"
+#include "lcd_hal/io.h"
+
+NanoEngineProfiler::NanoEngineProfiler(NanoEngineFrameStats *frames, uint16_t size)
+    : m_frames( frames )
+    , m_size( size )
+{
+}
+
+void NanoEngineProfiler::beginFrame()
+{
+    uint32_t updateUs = m_current.updateUs;
+    m_current = NanoEngineFrameStats{};
+    m_current.timestamp = lcd_millis();
+    m_current.updateUs = updateUs;
+}
+
+void NanoEngineProfiler::endFrame()
+{
+    m_frames[m_head] = m_current;
+    m_head = (m_head + 1) % m_size;
+    if ( m_count < m_size )
+    {
+        m_count++;
+    }
+    m_current = NanoEngineFrameStats{};
+}
+
+void NanoEngineProfiler::addTile(uint32_t rasterUs, uint32_t busUs, uint32_t bytes)
+{
+    m_current.tiles++;
+    m_current.rasterUs += rasterUs;
+    m_current.busUs += busUs;
+    m_current.bytes += bytes;
+    if ( rasterUs > m_current.rasterMaxUs )
+    {
+        m_current.rasterMaxUs = rasterUs;
+    }
+    if ( busUs > m_current.busMaxUs )
+    {
+        m_current.busMaxUs = busUs;
+    }
+}
+
+const NanoEngineFrameStats &NanoEngineProfiler::frame(uint16_t index) const
+{
+    return m_frames[(m_head + m_size - m_count + index) % m_size];
+}
+
+void NanoEngineProfiler::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_current = NanoEngineFrameStats{};
+}
+
+#if defined(NE_PROFILER_DUMP_AVAILABLE)
+
+int NanoEngineProfiler::dumpCsv(FILE *file) const
+{
+    if ( fprintf( file, "timestamp,update_us,raster_us,raster_max_us,bus_us,bus_max_us,bytes,tiles\n" ) < 0 )
+    {
+        return -1;
+    }
+    for (uint16_t i = 0; i < m_count; i++)
+    {
+        const NanoEngineFrameStats &f = frame( i );
+        if ( fprintf( file, "%u,%u,%u,%u,%u,%u,%u,%u\n",
+                      (unsigned)f.timestamp, (unsigned)f.updateUs, (unsigned)f.rasterUs,
+                      (unsigned)f.rasterMaxUs, (unsigned)f.busUs, (unsigned)f.busMaxUs,
+                      (unsigned)f.bytes, (unsigned)f.tiles ) < 0 )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int NanoEngineProfiler::dumpJson(FILE *file) const
+{
+    if ( fprintf( file, "[" ) < 0 )
+    {
+        return -1;
+    }
+    for (uint16_t i = 0; i < m_count; i++)
+    {
+        const NanoEngineFrameStats &f = frame( i );
+        if ( fprintf( file, "%s\n  {\"timestamp\": %u, \"update_us\": %u, \"raster_us\": %u, "
+                            "\"raster_max_us\": %u, \"bus_us\": %u, \"bus_max_us\": %u, "
+                            "\"bytes\": %u, \"tiles\": %u}",
+                      i ? "," : "",
+                      (unsigned)f.timestamp, (unsigned)f.updateUs, (unsigned)f.rasterUs,
+                      (unsigned)f.rasterMaxUs, (unsigned)f.busUs, (unsigned)f.busMaxUs,
+                      (unsigned)f.bytes, (unsigned)f.tiles ) < 0 )
+        {
+            return -1;
+        }
+    }
+    return fprintf( file, "\n]\n" ) < 0 ? -1 : 0;
+}
+
+#endif
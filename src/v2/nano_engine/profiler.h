@@ -0,0 +1,168 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file profiler.h Per-frame timing statistics of NanoEngine
+ */
+
+#ifndef _NANO_ENGINE_PROFILER_H_
+#define _NANO_ENGINE_PROFILER_H_
+
+#include <stdint.h>
+
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO)
+/** Defined if NanoEngine profiler can dump statistics to files */
+#define NE_PROFILER_DUMP_AVAILABLE
+#include <stdio.h>
+#endif
+
+/**
+ * @ingroup NANO_ENGINE_API_V2
+ * @{
+ */
+
+/**
+ * Statistics of single NanoEngine frame. All durations are in microseconds.
+ * Each area, sent to the display, is counted as a tile: with scratch buffer
+ * a tile can contain several engine tiles.
+ */
+typedef struct
+{
+    uint32_t timestamp;    ///< time of display() call in milliseconds
+    uint32_t updateUs;     ///< duration of update() calls since previous frame
+    uint32_t rasterUs;     ///< total time of rendering tiles to canvas
+    uint32_t rasterMaxUs;  ///< the longest rendering of single tile
+    uint32_t busUs;        ///< total time of sending tiles to display
+    uint32_t busMaxUs;     ///< the longest sending of single tile
+    uint32_t bytes;        ///< number of bytes of pixel data, sent to display
+    uint16_t tiles;        ///< number of rendered tiles
+} NanoEngineFrameStats;
+
+/**
+ * Ring buffer of NanoEngine frame statistics. When the buffer is full, the oldest
+ * frame is replaced with new one. Use NanoEngineProfilerN to allocate the buffer,
+ * and connect profiler to the engine via setProfiler() method.
+ */
+class NanoEngineProfiler
+{
+public:
+    /**
+     * Starts new frame
+     */
+    void beginFrame();
+
+    /**
+     * Completes current frame and stores it to the ring buffer
+     */
+    void endFrame();
+
+    /**
+     * Adds duration of objects update to current frame
+     *
+     * @param us duration in microseconds
+     */
+    void addUpdate(uint32_t us) { m_current.updateUs += us; }
+
+    /**
+     * Adds rendered tile to current frame
+     *
+     * @param rasterUs duration of rendering in microseconds
+     * @param busUs duration of sending to the display in microseconds
+     * @param bytes number of bytes sent to the display
+     */
+    void addTile(uint32_t rasterUs, uint32_t busUs, uint32_t bytes);
+
+    /**
+     * Returns number of frames in the buffer
+     */
+    uint16_t count() const { return m_count; }
+
+    /**
+     * Returns statistics of the frame
+     *
+     * @param index frame index, 0 is the oldest frame, count() - 1 is the latest one
+     */
+    const NanoEngineFrameStats &frame(uint16_t index) const;
+
+    /**
+     * Removes all frames from the buffer
+     */
+    void clear();
+
+#if defined(NE_PROFILER_DUMP_AVAILABLE)
+    /**
+     * Writes all frames to the file as CSV table with header line
+     *
+     * @param file file to write to
+     * @return 0 on success, negative value on error
+     */
+    int dumpCsv(FILE *file) const;
+
+    /**
+     * Writes all frames to the file as JSON array of objects
+     *
+     * @param file file to write to
+     * @return 0 on success, negative value on error
+     */
+    int dumpJson(FILE *file) const;
+#endif
+
+protected:
+    /**
+     * Initializes profiler over user-provided buffer
+     *
+     * @param frames array for frame statistics
+     * @param size number of elements in frames array
+     */
+    NanoEngineProfiler(NanoEngineFrameStats *frames, uint16_t size);
+
+private:
+    NanoEngineFrameStats *m_frames;
+    uint16_t m_size;
+    uint16_t m_head = 0;
+    uint16_t m_count = 0;
+    NanoEngineFrameStats m_current{};
+};
+
+/**
+ * NanoEngine profiler, storing statistics of last N frames
+ *
+ * @tparam N number of frames to keep
+ */
+template <uint16_t N>
+class NanoEngineProfilerN: public NanoEngineProfiler
+{
+public:
+    NanoEngineProfilerN(): NanoEngineProfiler( m_buffer, N )
+    {
+    }
+
+private:
+    NanoEngineFrameStats m_buffer[N]{};
+};
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,149 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "render_workers.h"
+
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct NanoEngineWorkersState
+{
+    explicit NanoEngineWorkersState(uint8_t count)
+        : rendered( count )
+        , sent( count )
+    {
+    }
+
+    uint16_t jobs = 0;
+    uint32_t frame = 0;
+    bool stop = false;
+    std::vector<uint16_t> rendered;
+    std::vector<uint16_t> sent;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::mutex userMutex;
+    std::condition_variable cond;
+};
+
+NanoEngineWorkers::NanoEngineWorkers(uint8_t count, JobFunc render, JobFunc send, void *arg)
+    : m_count( count )
+    , m_render( render )
+    , m_send( send )
+    , m_arg( arg )
+    , m_state( new NanoEngineWorkersState( count ) )
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        m_state->threads.push_back( std::thread( &NanoEngineWorkers::work, this, i ) );
+    }
+}
+
+NanoEngineWorkers::~NanoEngineWorkers()
+{
+    {
+        std::unique_lock<std::mutex> lock( m_state->mutex );
+        m_state->stop = true;
+    }
+    m_state->cond.notify_all();
+    for (auto &thread: m_state->threads)
+    {
+        thread.join();
+    }
+    delete m_state;
+}
+
+void NanoEngineWorkers::lock()
+{
+    m_state->userMutex.lock();
+}
+
+void NanoEngineWorkers::unlock()
+{
+    m_state->userMutex.unlock();
+}
+
+void NanoEngineWorkers::run(uint16_t jobs)
+{
+    std::unique_lock<std::mutex> lock( m_state->mutex );
+    m_state->jobs = jobs;
+    /* Counters hold number of the last job + 1, so 0 means nothing is done */
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        m_state->rendered[i] = 0;
+        m_state->sent[i] = 0;
+    }
+    m_state->frame++;
+    m_state->cond.notify_all();
+    for (uint16_t job = 0; job < jobs; job++)
+    {
+        uint8_t worker = job % m_count;
+        while ( m_state->rendered[worker] != job + 1 )
+        {
+            m_state->cond.wait( lock );
+        }
+        lock.unlock();
+        m_send( m_arg, worker, job );
+        lock.lock();
+        /* Worker canvas is free now, and can be used for the next job */
+        m_state->sent[worker] = job + 1;
+        m_state->cond.notify_all();
+    }
+}
+
+void NanoEngineWorkers::work(uint8_t worker)
+{
+    uint32_t frame = 0;
+    std::unique_lock<std::mutex> lock( m_state->mutex );
+    for (;;)
+    {
+        while ( frame == m_state->frame && !m_state->stop )
+        {
+            m_state->cond.wait( lock );
+        }
+        if ( m_state->stop )
+        {
+            break;
+        }
+        frame = m_state->frame;
+        for (uint16_t job = worker; job < m_state->jobs; job += m_count)
+        {
+            /* Wait until previous job of this worker is sent to the display */
+            while ( job >= m_count && m_state->sent[worker] != job - m_count + 1 )
+            {
+                m_state->cond.wait( lock );
+            }
+            lock.unlock();
+            m_render( m_arg, worker, job );
+            lock.lock();
+            m_state->rendered[worker] = job + 1;
+            m_state->cond.notify_all();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file render_workers.h Worker threads for parallel NanoEngine rendering
+ */
+
+#ifndef _NANO_ENGINE_RENDER_WORKERS_H_
+#define _NANO_ENGINE_RENDER_WORKERS_H_
+
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO)
+
+/** Defined if NanoEngine can render tiles in several threads */
+#define NE_PARALLEL_RENDER_AVAILABLE
+
+#include <stdint.h>
+
+/* Threading headers are not included here, since they conflict with min() and max() *
+ * macros, defined by the library                                                   */
+struct NanoEngineWorkersState;
+
+/**
+ * @ingroup NANO_ENGINE_API_V2
+ * @{
+ */
+
+/**
+ * Pool of threads, rendering NanoEngine tiles in parallel.
+ * Each worker owns single canvas, so worker N renders jobs N, N + count, N + 2 * count, ...
+ * Rendered jobs are passed back to the thread, which called run(), strictly in the
+ * order of job numbers. So, only the calling thread communicates with the display.
+ */
+class NanoEngineWorkers
+{
+public:
+    /** Function, called for each job. Worker index is passed to select worker canvas */
+    typedef void (*JobFunc)(void *arg, uint8_t worker, uint16_t job);
+
+    /**
+     * Creates pool and starts worker threads
+     *
+     * @param count number of worker threads
+     * @param render function to call from worker thread for each job
+     * @param send function to call from run() caller thread for each rendered job
+     * @param arg argument to pass to render and send functions
+     */
+    NanoEngineWorkers(uint8_t count, JobFunc render, JobFunc send, void *arg);
+
+    /**
+     * Stops and joins all worker threads
+     */
+    ~NanoEngineWorkers();
+
+    /**
+     * Renders jobs [0, jobs) by workers and sends them in order. Returns when
+     * all jobs are sent.
+     *
+     * @param jobs number of jobs to process
+     */
+    void run(uint16_t jobs);
+
+    /** Returns number of worker threads */
+    uint8_t count() const { return m_count; }
+
+    /**
+     * Locks mutex, used to serialize user callbacks, called from workers
+     */
+    void lock();
+
+    /**
+     * Unlocks mutex, used to serialize user callbacks, called from workers
+     */
+    void unlock();
+
+private:
+    uint8_t m_count;
+    JobFunc m_render;
+    JobFunc m_send;
+    void *m_arg;
+    NanoEngineWorkersState *m_state;
+
+    void work(uint8_t worker);
+};
+
+/**
+ * @}
+ */
+
+#endif
+
+#endif
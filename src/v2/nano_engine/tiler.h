@@ -31,16 +31,16 @@
 #include "canvas/rect.h"
 #include "canvas/canvas.h"
 #include "v2/lcd/base/display.h"
+#include "render_workers.h"
+#include "dirty_region.h"
+#include "object_index.h"
+#include "profiler.h"
 
 /**
  * @ingroup NANO_ENGINE_API_V2
  * @{
  */
 
-#ifndef NE_MAX_TILE_ROWS
-#define NE_MAX_TILE_ROWS 20      ///< Maximum tile rows supported. Can be defined outside the library
-#endif
-
 /**
  * Structure, holding currently set font.
  * @warning Only for internal use.
@@ -74,10 +74,16 @@
  */
 typedef bool (*TNanoEngineOnDraw)(void);
 
-template<class C, class D>
+/**
+ * Default structure, tracking tiles to refresh. Can be replaced with NanoDirtyRects<>
+ * via the last template argument of NanoEngine for sparse updates on large displays.
+ */
+typedef NanoDirtyTiles<NE_MAX_TILE_COLS, NE_MAX_TILE_ROWS> NanoDirtyTilesDefault;
+
+template<class C, class D, class R = NanoDirtyTilesDefault>
 class NanoEngine;
 
-template<class C, class D>
+template<class C, class D, class R = NanoDirtyTilesDefault>
 class NanoEngineTiler;
 
 /**
@@ -87,8 +93,9 @@ template<class T>
 class NanoEngineObject
 {
 public:
-    template<class C, class D>
+    template<class C, class D, class R>
     friend class NanoEngineTiler;
+    template<class N> friend class NanoObjectIndex;
 
     NanoEngineObject() = default;
 
@@ -159,8 +166,35 @@ protected:
      */
     void setTiler(T *tiler) { m_tiler = tiler; }
 
+    /**
+     * Returns true if area of the object is known to the spatial index
+     */
+    bool hasBounds() const { return m_bounded; }
+
+    /**
+     * Sets area, occupied by the object, for spatial index of NanoEngine.
+     * Objects, which never call this method, are drawn for every tile.
+     *
+     * @param rect area in the same coordinates, which object uses for drawing
+     */
+    void setBounds(const NanoRect &rect)
+    {
+        m_bounds = rect;
+        m_bounded = true;
+        if ( m_order && m_tiler )
+        {
+            m_tiler->updateObject( *this );
+        }
+    }
+
 private:
     bool m_focused = false;
+    bool m_bounded = false;
+    NanoRect m_bounds{};
+    /** Drawing order of the object in NanoEngine, 0 if object is not bound to NanoEngine */
+    uint16_t m_order = 0;
+    /** First entry of the object in spatial index */
+    uint16_t m_entry = 0xFFFF;
 };
 
 /**
@@ -171,8 +205,10 @@ private:
  * and 3 bits means 3^2 = 8.
  * If you need to have single big buffer, holding the whole content for monochrome display,
  * you can specify something like this NanoEngineTiler<NanoCanvas1,128,64,7>.
+ * The last argument R is the structure, tracking tiles to refresh: NanoDirtyTiles<> (default)
+ * or NanoDirtyRects<>.
  */
-template<class C, class D>
+template<class C, class D, class R>
 class NanoEngineTiler
 {
 protected:
@@ -183,20 +219,29 @@ protected:
         offset{0, 0},
         m_first( nullptr )
     {
+        m_tileWidth = canvas.width();
+        m_tileHeight = canvas.height();
         refresh();
     };
 
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+    ~NanoEngineTiler()
+    {
+        setParallelMode( 0 );
+    }
+#endif
+
 public:
     /**
      * This type is template argument for all Nano Objects.
      */
-    typedef NanoEngineTiler<C,D> TilerT;
+    typedef NanoEngineTiler<C,D,R> TilerT;
     /**
      * Marks all tiles for update. Actual update will take place in display() method.
      */
     void refresh()
     {
-        memset(m_refreshFlags,0xFF,sizeof(m_refreshFlags));
+        m_dirty.markAll();
     }
 
     /**
@@ -215,8 +260,11 @@ public:
      */
     void refresh(const NanoPoint &point) __attribute__ ((noinline))
     {
-        if ((point.x<0)||(point.y<0) || ((point.y/canvas.height())>=NE_MAX_TILE_ROWS)) return;
-        m_refreshFlags[(point.y/canvas.height())] |= (1<<(point.x/canvas.width()));
+        if ((point.x<0)||(point.y<0)) return;
+        if (((lcduint_t)point.x >= m_display.width()) || ((lcduint_t)point.y >= m_display.height())) return;
+        lcdint_t col = point.x/m_tileWidth;
+        lcdint_t row = point.y/m_tileHeight;
+        m_dirty.mark(col, row, col, row);
     }
 
     /**
@@ -228,15 +276,11 @@ public:
         if (y2 < 0 || x2 < 0) return;
         if (y1 < 0) y1 = 0;
         if (x1 < 0) x1 = 0;
-        y1 = y1/canvas.height();
-        y2 = min((y2/canvas.height()), NE_MAX_TILE_ROWS - 1);
-        for(uint8_t x=x1/canvas.width(); x<=(x2/canvas.width()); x++)
-        {
-            for (uint8_t y=y1; y<=y2; y++)
-            {
-                m_refreshFlags[y] |= (1<<x);
-            }
-        }
+        /* Tiles outside of display are not marked, so dirty region keeps partial update */
+        if (((lcduint_t)x1 >= m_display.width()) || ((lcduint_t)y1 >= m_display.height())) return;
+        if ((lcduint_t)x2 >= m_display.width()) x2 = m_display.width() - 1;
+        if ((lcduint_t)y2 >= m_display.height()) y2 = m_display.height() - 1;
+        m_dirty.mark(x1/m_tileWidth, y1/m_tileHeight, x2/m_tileWidth, y2/m_tileHeight);
     }
 
     /**
@@ -275,7 +319,8 @@ public:
      */
     void localCoordinates()
     {
-        canvas.offset -= offset;
+        NanoPoint canvasOffset = getCanvas().offset - offset;
+        getCanvas().setOffset( canvasOffset.x, canvasOffset.y );
     }
 
     /**
@@ -285,7 +330,8 @@ public:
      */
     void worldCoordinates()
     {
-        canvas.offset += offset;
+        NanoPoint canvasOffset = getCanvas().offset + offset;
+        getCanvas().setOffset( canvasOffset.x, canvasOffset.y );
     }
 
     /**
@@ -355,6 +401,9 @@ public:
         object.m_next = this->m_first;
         object.setTiler( this );
         m_first = &object;
+        object.m_order = 1;
+        m_orderValid = false;
+        updateObject( object );
         object.refresh();
     }
 
@@ -374,8 +423,7 @@ public:
         {
             object.refresh();
             this->m_first = object.m_next;
-            object.m_next = nullptr;
-            object.m_tiler = nullptr;
+            unbind( object );
         }
         else
         {
@@ -386,8 +434,7 @@ public:
                 {
                     object.refresh();
                     p->m_next = object.m_next;
-                    object.m_next = nullptr;
-                    object.m_tiler = nullptr;
+                    unbind( object );
                     break;
                 }
                 p = p->m_next;
@@ -400,18 +447,131 @@ public:
      */
     void update() __attribute__ ((noinline))
     {
+        uint32_t ts = m_profiler ? lcd_micros() : 0;
         NanoEngineObject<TilerT> *p = m_first;
         while (p)
         {
             p->update();
             p = p->m_next;
         }
+        if ( m_profiler )
+        {
+            m_profiler->addUpdate( lcd_micros() - ts );
+        }
+    }
+
+    /**
+     * Returns canvas, used by the NanoEngine. In parallel mode, when called from
+     * draw() methods and draw callback, returns canvas of the worker, rendering the tile.
+     */
+    C& getCanvas()
+    {
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+        if ( s_canvas )
+        {
+            return *s_canvas;
+        }
+#endif
+        return canvas;
+    }
+
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+    /**
+     * @brief Enables parallel rendering of tiles
+     *
+     * In parallel mode dirty tiles are rendered by several worker threads, each having
+     * its own canvas. Rendered tiles are sent to the display by the thread, which calls
+     * display(), in the same order as in normal mode. Each tile starts with colors,
+     * mode and font of the main canvas (see getCanvas()).
+     * Objects list must not be changed from draw() methods, and refresh() must not be
+     * called from them, since draw() methods of different objects are called in parallel.
+     * User draw callback is never called by two workers at once.
+     * Text with multibyte UTF-8 characters is not supported in parallel mode.
+     *
+     * @param threads number of worker threads, 0 to disable parallel mode
+     */
+    void setParallelMode(uint8_t threads)
+    {
+        delete m_workers;
+        m_workers = nullptr;
+        delete[] m_workerCanvas;
+        m_workerCanvas = nullptr;
+        delete[] m_tiles;
+        m_tiles = nullptr;
+        delete[] m_tileDrawn;
+        m_tileDrawn = nullptr;
+        delete[] m_tileRasterUs;
+        m_tileRasterUs = nullptr;
+        m_tilesSize = 0;
+        if ( threads )
+        {
+            m_workerCanvas = new C[threads];
+            m_workers = new NanoEngineWorkers( threads, renderTile, sendTile, this );
+        }
+    }
+#endif
+
+    /**
+     * @brief Sets scratch buffer for rendering several tiles at once
+     *
+     * If scratch buffer is set, adjacent dirty tiles of the same row are merged into
+     * single area, which is rendered by one pass over objects list and sent to the display
+     * as single block. If the whole rows are dirty, several rows are merged too.
+     * The size of merged area is limited by the size of scratch buffer.
+     * During rendering of merged area, canvas width and height (see getCanvas()) are
+     * equal to merged area size. Each area starts with colors, mode and font of the canvas.
+     * Scratch buffer is not used in parallel mode.
+     *
+     * @param buffer pointer to memory buffer, nullptr to render tiles one by one
+     * @param size size of the buffer in bytes
+     */
+    void setScratchBuffer(uint8_t *buffer, uint32_t size)
+    {
+        m_scratch = buffer;
+        m_scratchSize = size;
+    }
+
+    /**
+     * @brief Sets spatial index of objects
+     *
+     * With the index the engine calls draw() only for the objects, which can overlap
+     * the tile being rendered, instead of all objects. Objects must be NanoObject
+     * descendants to be indexed, others are drawn for every tile. Drawing order
+     * of the objects is preserved. Objects, updating their area directly, must call
+     * refresh() to update the index.
+     *
+     * @param index index to use, for example NanoObjectGrid<>, or nullptr to disable index
+     */
+    void setObjectIndex(NanoObjectIndex<TilerT> *index)
+    {
+        m_index = index;
+        rebuildIndex();
+    }
+
+    /**
+     * Updates position of the object in spatial index. It is called automatically,
+     * when object changes its area.
+     *
+     * @param object object bound to the engine
+     */
+    void updateObject(NanoEngineObject<TilerT> &object)
+    {
+        if ( m_index )
+        {
+            m_index->add( object );
+        }
     }
 
     /**
-     * Returns canvas, used by the NanoEngine.
+     * @brief Sets profiler, collecting per-frame statistics
+     *
+     * Profiler records durations of update(), rendering and sending of tiles, number of
+     * rendered tiles and bytes of pixel data for each frame. Timings use lcd_micros(),
+     * so they are available only on platforms, implementing it.
+     *
+     * @param profiler profiler to use, for example NanoEngineProfilerN<>, or nullptr to disable
      */
-    C& getCanvas() { return canvas; }
+    void setProfiler(NanoEngineProfiler *profiler) { m_profiler = profiler; }
 
     /**
      * Returns reference to display object.
@@ -429,9 +589,9 @@ protected:
 
     /**
      * Contains information on tiles to be updated.
-     * Elements of array are rows and bits are columns.
+     * Coordinates are in tiles: column and row.
      */
-    uint16_t   m_refreshFlags[NE_MAX_TILE_ROWS];
+    R          m_dirty;
 
     /**
      * @brief refreshes content on oled display.
@@ -456,8 +616,85 @@ private:
 
     NanoEngineObject<TilerT>  *m_first = nullptr;
 
+    /** Size of single tile in pixels */
+    lcduint_t m_tileWidth;
+    lcduint_t m_tileHeight;
+
+    /** Buffer for rendering merged tiles */
+    uint8_t *m_scratch = nullptr;
+    uint32_t m_scratchSize = 0;
+
+    /** Spatial index of objects */
+    NanoObjectIndex<TilerT> *m_index = nullptr;
+    /** Profiler, collecting frame statistics */
+    NanoEngineProfiler *m_profiler = nullptr;
+    /** Set to false, when the list changes and drawing order of objects needs to be updated */
+    bool m_orderValid = false;
+
+    void unbind(NanoEngineObject<TilerT> &object)
+    {
+        if ( m_index )
+        {
+            m_index->remove( object );
+        }
+        object.m_next = nullptr;
+        object.m_tiler = nullptr;
+        object.m_order = 0;
+        m_orderValid = false;
+    }
+
+    void rebuildIndex()
+    {
+        if ( m_index )
+        {
+            m_index->clear();
+        }
+        for (NanoEngineObject<TilerT> *p = m_first; p; p = p->m_next)
+        {
+            p->m_entry = NanoObjectIndex<TilerT>::NONE;
+            updateObject( *p );
+        }
+    }
+
+    /** Updates drawing order of objects before rendering the frame */
+    void prepareIndex()
+    {
+        if ( !m_index )
+        {
+            return;
+        }
+        if ( !m_orderValid )
+        {
+            uint16_t order = 1;
+            for (NanoEngineObject<TilerT> *p = m_first; p; p = p->m_next)
+            {
+                p->m_order = order++;
+            }
+            m_orderValid = true;
+        }
+        if ( m_index->overflow() )
+        {
+            /* Some entries may be released since last frame */
+            rebuildIndex();
+        }
+    }
+
     void draw() __attribute__ ((noinline))
     {
+        if ( m_index && !m_index->overflow() )
+        {
+            NanoEngineObject<TilerT> *objects[NE_MAX_DRAW_OBJECTS];
+            C &c = getCanvas();
+            int16_t count = m_index->find( { c.offset, c.offsetEnd() }, objects, NE_MAX_DRAW_OBJECTS );
+            if ( count >= 0 )
+            {
+                for (int16_t i = 0; i < count; i++)
+                {
+                    objects[i]->draw();
+                }
+                return;
+            }
+        }
         NanoEngineObject<TilerT> *p = m_first;
         while (p)
         {
@@ -465,54 +702,307 @@ private:
             p = p->m_next;
         }
     }
+
+    void displayTiles();
+    void displayMerged();
+    void renderArea(lcdint_t x, lcdint_t y, bool clear);
+    /** Returns number of bytes, sent to display for the canvas */
+    uint32_t areaBytes(C &area)
+    {
+        return (uint32_t)area.width() * area.height() * D::BITS_PER_PIXEL / 8;
+    }
+    bool isRowDirty(const R &dirty, lcdint_t row);
+
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+    NanoEngineWorkers *m_workers = nullptr;
+    C *m_workerCanvas = nullptr;
+    /** Positions of dirty tiles, rendered in current frame */
+    NanoPoint *m_tiles = nullptr;
+    /** Non-zero for the tiles, which need to be sent to the display */
+    uint8_t *m_tileDrawn = nullptr;
+    /** Rendering time of the tiles for profiler */
+    uint32_t *m_tileRasterUs = nullptr;
+    uint16_t m_tilesSize = 0;
+    /** Canvas of the worker, running in current thread */
+    static thread_local C *s_canvas;
+
+    void displayBufferParallel();
+    static void renderTile(void *arg, uint8_t worker, uint16_t job);
+    static void sendTile(void *arg, uint8_t worker, uint16_t job);
+#endif
 };
 
-template<class C, class D>
-void NanoEngineTiler<C,D>::displayBuffer()
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+template<class C, class D, class R>
+thread_local C *NanoEngineTiler<C,D,R>::s_canvas = nullptr;
+#endif
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::displayBuffer()
+{
+    prepareIndex();
+    if ( m_profiler )
+    {
+        m_profiler->beginFrame();
+    }
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+    if ( m_workers )
+    {
+        displayBufferParallel();
+    }
+    else
+#endif
+    if ( m_scratch )
+    {
+        displayMerged();
+    }
+    else
+    {
+        displayTiles();
+    }
+    if ( m_profiler )
+    {
+        m_profiler->endFrame();
+    }
+}
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::renderArea(lcdint_t x, lcdint_t y, bool clear)
+{
+    uint32_t ts = m_profiler ? lcd_micros() : 0;
+    bool drawn = true;
+    canvas.setOffset(x + offset.x, y + offset.y);
+    if ( m_onDraw == nullptr )
+    {
+        if ( clear )
+        {
+            canvas.clear();
+        }
+        draw();
+    }
+    else if ( m_onDraw() )
+    {
+        draw();
+    }
+    else
+    {
+        drawn = false;
+    }
+    uint32_t rasterTs = m_profiler ? lcd_micros() : 0;
+    if ( drawn )
+    {
+        this->m_display.drawCanvas(x,y,canvas);
+    }
+    if ( m_profiler )
+    {
+        m_profiler->addTile( rasterTs - ts, lcd_micros() - rasterTs, drawn ? areaBytes( canvas ) : 0 );
+    }
+}
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::displayTiles()
 {
-//    printf("--------------\n");
-    for (lcduint_t y = 0; y < m_display.height(); y = y + canvas.height())
+    /* Areas, marked for refresh while drawing, are updated in the next frame */
+    R dirty = m_dirty;
+    m_dirty.clear();
+    lcdint_t row = 0;
+    for (lcduint_t y = 0; y < m_display.height(); y = y + canvas.height(), row++)
     {
-        uint16_t flag = m_refreshFlags[y/canvas.height()];
-        m_refreshFlags[y/canvas.height()] = 0;
-//        printf("|%d%d%d%d%d%d%d%d|\n", flag & 1, (flag >> 1) & 1, (flag >> 2) & 1, (flag >> 3) & 1, (flag >> 4) & 1, (flag >> 5) & 1,(flag >> 6) & 1,(flag >> 7) & 1 );
-        for (lcduint_t x = 0; x < m_display.width(); x = x + canvas.width())
+        lcdint_t col = 0;
+        for (lcduint_t x = 0; x < m_display.width(); x = x + canvas.width(), col++)
         {
-            if (flag & 0x01)
+            if (dirty.contains(col, row))
             {
-                canvas.setOffset(x + offset.x, y + offset.y);
-                if ( m_onDraw == nullptr )
-                {
-                    canvas.clear();
-                    draw();
-                    this->m_display.drawCanvas(x,y,canvas);
-                }
-                else if ( m_onDraw() )
+                renderArea(x, y, true);
+            }
+        }
+    }
+}
+
+template<class C, class D, class R>
+bool NanoEngineTiler<C,D,R>::isRowDirty(const R &dirty, lcdint_t row)
+{
+    lcdint_t col = 0;
+    for (lcduint_t x = 0; x < m_display.width(); x = x + m_tileWidth, col++)
+    {
+        if (!dirty.contains(col, row))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::displayMerged()
+{
+    R dirty = m_dirty;
+    m_dirty.clear();
+    uint8_t *tile = canvas.getData();
+    /* begin() resets canvas settings, so they are saved to restore them for each area */
+    NanoCanvasOps<C::BITS_PER_PIXEL> settings;
+    settings.copySettings( canvas );
+    const uint32_t tileSize = (uint32_t)m_tileWidth * m_tileHeight * C::BITS_PER_PIXEL / 8;
+    lcdint_t row = 0;
+    for (lcduint_t y = 0; y < m_display.height(); y = y + m_tileHeight, row++)
+    {
+        lcdint_t rows = 1;
+        lcdint_t col = 0;
+        for (lcduint_t x = 0; x < m_display.width(); x = x + m_tileWidth, col++)
+        {
+            if (!dirty.contains(col, row))
+            {
+                continue;
+            }
+            lcdint_t x1 = x;
+            lcduint_t width = m_tileWidth;
+            lcduint_t height = m_tileHeight;
+            uint32_t size = tileSize;
+            while ( (x + m_tileWidth < m_display.width()) && dirty.contains(col + 1, row) &&
+                    (size + tileSize <= m_scratchSize) )
+            {
+                width += m_tileWidth;
+                size += tileSize;
+                x += m_tileWidth;
+                col++;
+            }
+            if ( (x1 == 0) && (x + m_tileWidth >= m_display.width()) )
+            {
+                /* Whole rows are dirty, so next dirty rows can be merged too */
+                while ( (y + height < m_display.height()) && (size * (rows + 1) <= m_scratchSize) &&
+                        isRowDirty(dirty, row + rows) )
                 {
-                    draw();
-                    this->m_display.drawCanvas(x,y,canvas);
+                    height += m_tileHeight;
+                    rows++;
                 }
             }
-            flag >>=1;
+            if ( size * rows > m_scratchSize )
+            {
+                /* Scratch buffer is smaller than single tile */
+                canvas.begin( width, height, tile );
+            }
+            else
+            {
+                canvas.begin( width, height, m_scratch );
+            }
+            canvas.copySettings( settings );
+            /* begin() has already cleared the buffer */
+            renderArea(x1, y, false);
         }
+        y += (rows - 1) * m_tileHeight;
+        row += rows - 1;
     }
+    canvas.begin( m_tileWidth, m_tileHeight, tile );
+    canvas.copySettings( settings );
 }
 
-template<class C, class D>
-void NanoEngineTiler<C,D>::displayPopup(const char *msg)
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::displayBufferParallel()
+{
+    uint16_t size = ((m_display.width() + canvas.width() - 1) / canvas.width()) *
+                    ((m_display.height() + canvas.height() - 1) / canvas.height());
+    if ( size > m_tilesSize )
+    {
+        delete[] m_tiles;
+        delete[] m_tileDrawn;
+        delete[] m_tileRasterUs;
+        m_tiles = new NanoPoint[size];
+        m_tileDrawn = new uint8_t[size];
+        m_tileRasterUs = new uint32_t[size];
+        m_tilesSize = size;
+    }
+    uint16_t count = 0;
+    lcdint_t row = 0;
+    for (lcduint_t y = 0; y < m_display.height(); y = y + canvas.height(), row++)
+    {
+        lcdint_t col = 0;
+        for (lcduint_t x = 0; x < m_display.width(); x = x + canvas.width(), col++)
+        {
+            if (m_dirty.contains(col, row))
+            {
+                m_tiles[count++] = (NanoPoint){ (lcdint_t)x, (lcdint_t)y };
+            }
+        }
+    }
+    m_dirty.clear();
+    if ( count )
+    {
+        m_workers->run( count );
+    }
+}
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::renderTile(void *arg, uint8_t worker, uint16_t job)
+{
+    TilerT *tiler = static_cast<TilerT *>(arg);
+    uint32_t ts = tiler->m_profiler ? lcd_micros() : 0;
+    C &canvas = tiler->m_workerCanvas[worker];
+    const NanoPoint &p = tiler->m_tiles[job];
+    s_canvas = &canvas;
+    canvas.copySettings( tiler->canvas );
+    canvas.setOffset(p.x + tiler->offset.x, p.y + tiler->offset.y);
+    bool drawn = true;
+    if ( tiler->m_onDraw == nullptr )
+    {
+        canvas.clear();
+        tiler->draw();
+    }
+    else
+    {
+        tiler->m_workers->lock();
+        drawn = tiler->m_onDraw();
+        tiler->m_workers->unlock();
+        if ( drawn )
+        {
+            tiler->draw();
+        }
+    }
+    tiler->m_tileDrawn[job] = drawn;
+    s_canvas = nullptr;
+    if ( tiler->m_profiler )
+    {
+        tiler->m_tileRasterUs[job] = lcd_micros() - ts;
+    }
+}
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::sendTile(void *arg, uint8_t worker, uint16_t job)
+{
+    TilerT *tiler = static_cast<TilerT *>(arg);
+    uint32_t ts = tiler->m_profiler ? lcd_micros() : 0;
+    C &canvas = tiler->m_workerCanvas[worker];
+    if ( tiler->m_tileDrawn[job] )
+    {
+        const NanoPoint &p = tiler->m_tiles[job];
+        tiler->m_display.drawCanvas(p.x, p.y, canvas);
+    }
+    if ( tiler->m_profiler )
+    {
+        tiler->m_profiler->addTile( tiler->m_tileRasterUs[job], lcd_micros() - ts,
+                                    tiler->m_tileDrawn[job] ? tiler->areaBytes( canvas ) : 0 );
+    }
+}
+#endif
+
+template<class C, class D, class R>
+void NanoEngineTiler<C,D,R>::displayPopup(const char *msg)
 {
     NanoRect rect = { {8, (m_display.height()>>1) - 8}, {m_display.width() - 8, (m_display.height()>>1) + 8} };
     // TODO: It would be nice to calculate message height
     NanoPoint textPos = { (m_display.width() - (lcdint_t)strlen(msg)*m_display.getFont().getHeader().width) >> 1,
                                                (m_display.height()>>1) - 4 };
     refresh(rect);
-    for (lcduint_t y = 0; y < m_display.height(); y = y + canvas.height())
+    prepareIndex();
+    R dirty = m_dirty;
+    m_dirty.clear();
+    lcdint_t row = 0;
+    for (lcduint_t y = 0; y < m_display.height(); y = y + canvas.height(), row++)
     {
-        uint16_t flag = m_refreshFlags[y/canvas.height()];
-        m_refreshFlags[y/canvas.height()] = 0;
-        for (lcduint_t x = 0; x < m_display.width(); x = x + canvas.width())
+        lcdint_t col = 0;
+        for (lcduint_t x = 0; x < m_display.width(); x = x + canvas.width(), col++)
         {
-            if (flag & 0x01)
+            if (dirty.contains(col, row))
             {
                 canvas.setOffset(x + offset.x, y + offset.y);
                 if (!m_onDraw)
@@ -529,11 +1019,13 @@ void NanoEngineTiler<C,D>::displayPopup(const char *msg)
                 canvas.fillRect(rect);
                 canvas.setColor(RGB_COLOR8(192,192,192));
                 canvas.drawRect(rect);
+                /* Long messages must not be drawn outside of popup frame */
+                canvas.pushClip(rect);
                 canvas.printFixed( textPos.x, textPos.y, msg);
+                canvas.popClip();
 
                 m_display.drawCanvas(x,y,canvas);
             }
-            flag >>=1;
         }
     }
 }
@@ -213,7 +213,8 @@ def generate_custom_def(name, type=["void",""], code=[]):
     return fill_template('\n'.join(lines))
 
 def generate_set_block_content():
-    lines = ["    lcduint_t rx = w ? (x + w - 1) : (m_base.width() - 1);",
+    lines = ["    lcd_notifyStartBlock( static_cast<I &>(*this) );",
+             "    lcduint_t rx = w ? (x + w - 1) : (m_base.width() - 1);",
              "    commandStart();" ]
     lines.append("    this->send({0});".format(get_val_by_path("options/col_cmd", "0x22")))
     if not get_val_by_path("options/args_in_cmd_mode", False):
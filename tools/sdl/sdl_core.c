@@ -41,6 +41,12 @@
 
 #define CANVAS_REFRESH_RATE  60
 
+#define SDL_DEFAULT_SPI_FREQUENCY  8000000
+#define SDL_DEFAULT_I2C_FREQUENCY  400000
+/* i2c start condition and address byte with ACK, and stop condition, in bits */
+#define SDL_I2C_START_BITS  10
+#define SDL_I2C_STOP_BITS   1
+
 enum
 {
     SDL_AUTODETECT,
@@ -62,6 +68,16 @@ static sdl_data_mode s_active_data_mode = SDM_COMMAND_ARG;
 
 static int s_oled = SDL_AUTODETECT;
 
+/* Bus timing model. All times are in picoseconds */
+static uint64_t s_spiBitPs = 1000000000000ull / SDL_DEFAULT_SPI_FREQUENCY;
+static uint64_t s_i2cBitPs = 1000000000000ull / SDL_DEFAULT_I2C_FREQUENCY;
+static uint64_t s_dcLatencyPs = 0;
+static int s_lastDc = -1;
+static uint64_t s_busTimePs = 0;
+static int s_realtime = 0;
+static uint64_t s_realtimeBusPs = 0;
+static uint64_t s_realtimeTicks = 0;
+
 
 static void register_oled(sdl_oled_info *oled_info)
 {
@@ -88,6 +104,14 @@ void sdl_core_init(void)
     s_oled = SDL_AUTODETECT;
     s_dcPin = -1;
     memset(s_gpioKeys, 0, sizeof(s_gpioKeys));
+    s_lastDc = -1;
+    /* Each display starts with default bus timings, unless it sets its own */
+    s_spiBitPs = 1000000000000ull / SDL_DEFAULT_SPI_FREQUENCY;
+    s_i2cBitPs = 1000000000000ull / SDL_DEFAULT_I2C_FREQUENCY;
+    s_dcLatencyPs = 0;
+    s_busTimePs = 0;
+    s_realtimeBusPs = 0;
+    s_realtimeTicks = SDL_GetPerformanceCounter();
 
     register_oled( &sdl_sh1107 );
     register_oled( &sdl_ssd1306 );
@@ -176,10 +200,66 @@ void sdl_core_close(void)
 //////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////
 
+void sdl_core_set_spi_frequency(uint32_t frequency)
+{
+    s_spiBitPs = 1000000000000ull / ( frequency ? frequency : SDL_DEFAULT_SPI_FREQUENCY );
+}
+
+void sdl_core_set_i2c_frequency(uint32_t frequency)
+{
+    s_i2cBitPs = 1000000000000ull / ( frequency ? frequency : SDL_DEFAULT_I2C_FREQUENCY );
+}
+
+void sdl_core_set_dc_latency(uint32_t latency_ns)
+{
+    s_dcLatencyPs = (uint64_t)latency_ns * 1000;
+}
+
+void sdl_core_set_realtime(int enable)
+{
+    s_realtime = enable;
+    s_realtimeBusPs = s_busTimePs;
+    s_realtimeTicks = SDL_GetPerformanceCounter();
+}
+
+uint32_t sdl_core_get_bus_time_us(void)
+{
+    return (uint32_t)( s_busTimePs / 1000000 );
+}
+
+void sdl_core_reset_bus_time(void)
+{
+    s_busTimePs = 0;
+    s_realtimeBusPs = 0;
+    s_realtimeTicks = SDL_GetPerformanceCounter();
+}
+
+static void sdl_bus_throttle(void)
+{
+    uint64_t ticks = SDL_GetPerformanceCounter();
+    uint64_t wallUs = ( ticks - s_realtimeTicks ) * 1000000 / SDL_GetPerformanceFrequency();
+    uint64_t busUs = ( s_busTimePs - s_realtimeBusPs ) / 1000000;
+    if ( wallUs >= busUs )
+    {
+        /* Emulation is slower than the bus, nothing to wait for. Do not accumulate
+           the difference, otherwise next transactions would run faster than real ones */
+        s_realtimeBusPs = s_busTimePs;
+        s_realtimeTicks = ticks;
+    }
+    else if ( busUs - wallUs >= 1000 )
+    {
+        SDL_Delay( (uint32_t)( ( busUs - wallUs ) / 1000 ) );
+    }
+}
+
 void sdl_send_init()
 {
     s_active_data_mode = SDM_COMMAND_ARG;
     s_ssdMode = SSD_MODE_NONE;
+    if ( s_dcPin < 0 )
+    {
+        s_busTimePs += SDL_I2C_START_BITS * s_i2cBitPs;
+    }
 }
 
 
@@ -208,8 +288,28 @@ static void sdl_write_data(uint8_t data)
     }
 }
 
+static void sdl_bus_add_bytes(int count)
+{
+    if ( s_dcPin >= 0 )
+    {
+        int dc = s_digitalPins[s_dcPin] ? 1 : 0;
+        if ( s_lastDc >= 0 && dc != s_lastDc )
+        {
+            s_busTimePs += s_dcLatencyPs;
+        }
+        s_lastDc = dc;
+        s_busTimePs += 8 * s_spiBitPs * count;
+    }
+    else
+    {
+        /* 8 data bits and ACK */
+        s_busTimePs += 9 * s_i2cBitPs * count;
+    }
+}
+
 void sdl_send_byte(uint8_t data)
 {
+    sdl_bus_add_bytes(1);
     if (s_dcPin>=0)
     {
         // for spi
@@ -271,8 +371,47 @@ void sdl_send_byte(uint8_t data)
     }
 }
 
+void sdl_send_buffer(const uint8_t *data, int size)
+{
+    if ( s_dcPin < 0 && s_ssdMode == SSD_MODE_NONE && size > 0 )
+    {
+        // i2c control byte selects command or data mode for the whole transaction
+        sdl_send_byte( *data++ );
+        size--;
+    }
+    if ( s_dcPin >= 0 )
+    {
+        s_ssdMode = s_digitalPins[s_dcPin] ? SSD_MODE_DATA : SSD_MODE_COMMAND;
+    }
+    if ( s_ssdMode == SSD_MODE_DATA && p_active_driver && p_active_driver->run_data_block )
+    {
+        if (p_active_driver->dataMode == SDMS_AUTO)
+        {
+            s_active_data_mode = SDM_WRITE_DATA;
+        }
+        if ( s_active_data_mode == SDM_WRITE_DATA )
+        {
+            sdl_bus_add_bytes( size );
+            p_active_driver->run_data_block( data, size );
+            return;
+        }
+    }
+    while ( size-- > 0 )
+    {
+        sdl_send_byte( *data++ );
+    }
+}
+
 void sdl_send_stop()
 {
+    if ( s_dcPin < 0 )
+    {
+        s_busTimePs += SDL_I2C_STOP_BITS * s_i2cBitPs;
+    }
+    if ( s_realtime )
+    {
+        sdl_bus_throttle();
+    }
     sdl_poll_event();
     sdl_graphics_refresh();
     s_ssdMode = -1;
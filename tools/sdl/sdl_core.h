@@ -64,6 +64,8 @@ extern void sdl_set_gpio_keys(const uint8_t * pins);
 extern void sdl_send_init();
 /** sends byte to emulated interface */
 extern void sdl_send_byte(uint8_t data);
+/** sends bytes to emulated interface. Display data are passed to emulated controller at once */
+extern void sdl_send_buffer(const uint8_t *data, int size);
 /** closes emulated interface */
 extern void sdl_send_stop();
 /** reads analog pin */
@@ -78,12 +80,57 @@ extern int sdl_is_dc_mode();
 extern void sdl_core_init(void);
 extern void sdl_core_draw(void);
 extern void sdl_core_close(void);
-/** Allocates buffer, returns number of bytes allocated */
+/** Maximum number of areas, reported by sdl_core_diff_pixels_data() */
+#define SDL_DIFF_MAX_AREAS  8
+/** Different pixels, located closer than this distance, are reported as single area */
+#define SDL_DIFF_AREA_GAP   4
+
+/** Rectangle area of display, inclusive */
+typedef struct
+{
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+} sdl_diff_area;
+
+/** Result of display content comparison */
+typedef struct
+{
+    int count;                                ///< number of different pixels
+    sdl_diff_area bounds;                     ///< rectangle, containing all different pixels
+    int areas;                                ///< number of valid entries in area
+    sdl_diff_area area[SDL_DIFF_MAX_AREAS];   ///< groups of different pixels
+} sdl_pixels_diff;
+
+/** Copies display content to the buffer, converting pixels to target bpp format */
 extern void sdl_core_get_pixels_data( uint8_t *pixels, uint8_t target_bpp );
+/**
+ * Compares display content with reference buffer in the format, returned by
+ * sdl_core_get_pixels_data(). Returns number of different pixels and fills diff
+ * structure with bounding areas of different pixels, or -1 on error.
+ */
+extern int sdl_core_diff_pixels_data( const uint8_t *reference, uint8_t target_bpp, sdl_pixels_diff *diff );
 /** Returns length in bytes, required to hold the data */
 extern int sdl_core_get_pixels_len( uint8_t target_bpp );
 extern void sdl_core_set_unittest_mode(void);
 
+/** Sets clock frequency of emulated spi bus in Hz (default is 8 MHz) */
+extern void sdl_core_set_spi_frequency(uint32_t frequency);
+/** Sets clock frequency of emulated i2c bus in Hz (default is 400 kHz) */
+extern void sdl_core_set_i2c_frequency(uint32_t frequency);
+/** Sets time in nanoseconds, spent by controller on each data/command pin switch */
+extern void sdl_core_set_dc_latency(uint32_t latency_ns);
+/**
+ * Enables or disables throttling of the emulator to real bus speed. If enabled,
+ * each transaction returns not earlier than it would return on real hardware.
+ */
+extern void sdl_core_set_realtime(int enable);
+/** Returns simulated bus transfer time in microseconds since last reset */
+extern uint32_t sdl_core_get_bus_time_us(void);
+/** Resets simulated bus transfer time, call it at the beginning of the frame */
+extern void sdl_core_reset_bus_time(void);
+
 #ifdef __cplusplus
 }
 #endif
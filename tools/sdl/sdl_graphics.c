@@ -22,6 +22,7 @@
     SOFTWARE.
 */
 
+#include "sdl_core.h"
 #include "sdl_graphics.h"
 #include "sdl_oled_basic.h"
 #include <unistd.h>
@@ -44,6 +45,14 @@ static int s_bpp = 16;
 static uint32_t s_pixfmt = SDL_PIXELFORMAT_RGB565;
 static bool s_unittest_mode = false;
 
+static void put_pixel8(int index, uint32_t color) { ((uint8_t *)g_pixels)[ index ] = color; }
+static void put_pixel16(int index, uint32_t color) { ((uint16_t *)g_pixels)[ index ] = color; }
+static void put_pixel32(int index, uint32_t color) { ((uint32_t *)g_pixels)[ index ] = color; }
+static void put_pixel_none(int index, uint32_t color) { }
+
+/* Selected once per display, so sdl_put_pixel() doesn't check bpp for every pixel */
+static void (*s_put_pixel)(int index, uint32_t color) = put_pixel16;
+
 static int windowWidth() { return s_width * PIXEL_SIZE + BORDER_SIZE * 2; };
 static int windowHeight() { return s_height * PIXEL_SIZE + BORDER_SIZE * 2 + TOP_HEADER; };
 
@@ -181,14 +190,20 @@ void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfm
     s_pixfmt = pixfmt;
     s_width = width;
     s_height = height;
+    switch (s_bpp)
+    {
+        case 8: s_put_pixel = put_pixel8; break;
+        case 16: s_put_pixel = put_pixel16; break;
+        case 32: s_put_pixel = put_pixel32; break;
+        default: s_put_pixel = put_pixel_none; break;
+    }
     if (g_texture)
     {
         SDL_DestroyTexture( g_texture );
         g_texture = NULL;
-        free(g_pixels);
-        g_pixels = NULL;
     }
-    g_pixels = malloc(s_width * s_height * (s_bpp / 8));
+    free(g_pixels);
+    g_pixels = calloc(s_width * s_height, s_bpp / 8);
     if ( s_unittest_mode )
     {
         return;
@@ -214,26 +229,46 @@ void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfm
 
 void sdl_put_pixel(int x, int y, uint32_t color)
 {
-    while (x >= s_width) x-= s_width;
-    while (y >= s_height) y-= s_height;
-    if (x<0) x = 0;
-    if (y<0) y = 0;
+    /* Out of range coordinates wrap around like in controller memory */
+    if ((unsigned)x >= (unsigned)s_width) x = x < 0 ? 0 : x % s_width;
+    if ((unsigned)y >= (unsigned)s_height) y = y < 0 ? 0 : y % s_height;
     if (g_pixels)
     {
-        int index = x + y * s_width;
-        switch (s_bpp)
+        s_put_pixel( x + y * s_width, color );
+    }
+}
+
+void sdl_put_pixels(int x, int y, int dx, const uint8_t *data, int count)
+{
+    int last = x + dx * (count - 1);
+    if ( !g_pixels || s_bpp > 16 || (unsigned)y >= (unsigned)s_height ||
+         (unsigned)x >= (unsigned)s_width || (unsigned)last >= (unsigned)s_width )
+    {
+        for (; count > 0; count--, x += dx)
         {
-            case 8:
-                ((uint8_t *)g_pixels)[ index ] = color;
-                break;
-            case 16:
-                ((uint16_t *)g_pixels)[ index ] = color;
-                break;
-            case 32:
-                ((uint32_t *)g_pixels)[ index ] = color;
-                break;
-            default:
-                break;
+            sdl_put_pixel( x, y, s_bpp == 16 ? ((data[0] << 8) | data[1]) : data[0] );
+            data += s_bpp / 8;
+        }
+        return;
+    }
+    if ( s_bpp == 16 )
+    {
+        uint16_t *p = (uint16_t *)g_pixels + x + y * s_width;
+        for (; count > 0; count--, p += dx, data += 2)
+        {
+            *p = (data[0] << 8) | data[1];
+        }
+    }
+    else if ( dx == 1 )
+    {
+        memcpy( (uint8_t *)g_pixels + x + y * s_width, data, count );
+    }
+    else
+    {
+        uint8_t *p = (uint8_t *)g_pixels + x + y * s_width;
+        for (; count > 0; count--, p += dx)
+        {
+            *p = *data++;
         }
     }
 }
@@ -275,45 +310,221 @@ void sdl_graphics_close(void)
     SDL_DestroyWindow(g_window);
 }
 
-static uint32_t convert_pixel( uint32_t value, uint8_t target_bpp )
+/* Converts row of display pixels to RGBX8888 format */
+static void row_to_rgbx(int y, uint32_t *row)
 {
-    uint32_t pixel;
+    int x;
     switch ( s_pixfmt )
     {
-        case SDL_PIXELFORMAT_RGB332: pixel = ((value & 0xE0) << 24) | ((value & 0x1C) << 19) | ((value & 0x03) << 14) | ( 0xFF ); break;
-        case SDL_PIXELFORMAT_RGB565: pixel = ((value & 0xF800) << 16) | ((value & 0x07E0) << 13) | ((value & 0x001F) << 11) | ( 0xFF ); break;
-        case SDL_PIXELFORMAT_RGBX8888: pixel = value; break;
-        default: pixel = 0; break;
+        case SDL_PIXELFORMAT_RGB332:
+        {
+            const uint8_t *src = (const uint8_t *)g_pixels + y * s_width;
+            for (x = 0; x < s_width; x++)
+            {
+                uint32_t value = src[x];
+                row[x] = ((value & 0xE0) << 24) | ((value & 0x1C) << 19) | ((value & 0x03) << 14) | ( 0xFF );
+            }
+            break;
+        }
+        case SDL_PIXELFORMAT_RGB565:
+        {
+            const uint16_t *src = (const uint16_t *)g_pixels + y * s_width;
+            for (x = 0; x < s_width; x++)
+            {
+                uint32_t value = src[x];
+                row[x] = ((value & 0xF800) << 16) | ((value & 0x07E0) << 13) | ((value & 0x001F) << 11) | ( 0xFF );
+            }
+            break;
+        }
+        case SDL_PIXELFORMAT_RGBX8888:
+            memcpy( row, (const uint32_t *)g_pixels + y * s_width, s_width * sizeof(uint32_t) );
+            break;
+        default:
+            memset( row, 0, s_width * sizeof(uint32_t) );
+            break;
     }
+}
+
+/* Packs row of RGBX8888 pixels to the target format */
+static void rgbx_to_target(int y, const uint32_t *row, uint8_t *pixels, uint8_t target_bpp)
+{
+    int x;
     switch ( target_bpp )
     {
-        case 1: pixel = (pixel & 0xFFFFFF00) ? 1 : 0; break;
-        case 4: pixel = (pixel & 0x000000F0) >> 4; break;
-        case 8: pixel = ((pixel & 0xE0000000) >> 24) | ((pixel & 0x00E00000) >> 19) | ((pixel & 0x0000C000) >> 14); break;
-        case 16: pixel = ((pixel & 0xF8000000) >> 16) | ((pixel & 0x00FC0000) >> 13) | ((pixel & 0x0000F800) >> 11); break;
-        case 32: break;
-        default: break;
+        case 1:
+        {
+            uint8_t *dst = pixels + (y / 8) * s_width;
+            uint8_t mask = 1 << (y & 0x07);
+            for (x = 0; x < s_width; x++)
+            {
+                if ( row[x] & 0xFFFFFF00 ) dst[x] |= mask;
+            }
+            break;
+        }
+        case 4:
+        {
+            uint8_t *dst = pixels + y * s_width / 2;
+            for (x = 0; x < s_width; x++)
+            {
+                dst[x / 2] |= ((row[x] & 0x000000F0) >> 4) << ((x & 1) * 4);
+            }
+            break;
+        }
+        case 8:
+        {
+            uint8_t *dst = pixels + y * s_width;
+            for (x = 0; x < s_width; x++)
+            {
+                uint32_t p = row[x];
+                dst[x] = ((p & 0xE0000000) >> 24) | ((p & 0x00E00000) >> 19) | ((p & 0x0000C000) >> 14);
+            }
+            break;
+        }
+        case 16:
+        {
+            uint16_t *dst = (uint16_t *)pixels + y * s_width;
+            for (x = 0; x < s_width; x++)
+            {
+                uint32_t p = row[x];
+                dst[x] = ((p & 0xF8000000) >> 16) | ((p & 0x00FC0000) >> 13) | ((p & 0x0000F800) >> 11);
+            }
+            break;
+        }
+        case 32:
+            memcpy( (uint32_t *)pixels + y * s_width, row, s_width * sizeof(uint32_t) );
+            break;
+        default:
+            break;
     }
-    return pixel;
 }
 
 void sdl_core_get_pixels_data( uint8_t *pixels, uint8_t target_bpp )
 {
-    for (int x = 0; x < s_width; x++)
-        for (int y = 0; y < s_height; y++)
+    if ( target_bpp < 8 )
+    {
+        /* Packed formats are assembled with OR operation */
+        memset( pixels, 0, sdl_core_get_pixels_len( target_bpp ) );
+    }
+    if ( !g_pixels )
+    {
+        return;
+    }
+    /* Native format doesn't require conversion */
+    if ( ( target_bpp == 8 && s_pixfmt == SDL_PIXELFORMAT_RGB332 ) ||
+         ( target_bpp == 16 && s_pixfmt == SDL_PIXELFORMAT_RGB565 ) ||
+         ( target_bpp == 32 && s_pixfmt == SDL_PIXELFORMAT_RGBX8888 ) )
+    {
+        memcpy( pixels, g_pixels, sdl_core_get_pixels_len( target_bpp ) );
+        return;
+    }
+    uint32_t *row = malloc( s_width * sizeof(uint32_t) );
+    if ( !row )
+    {
+        return;
+    }
+    for (int y = 0; y < s_height; y++)
+    {
+        row_to_rgbx( y, row );
+        rgbx_to_target( y, row, pixels, target_bpp );
+    }
+    free( row );
+}
+
+static uint32_t get_target_pixel( const uint8_t *pixels, int x, int y, uint8_t target_bpp )
+{
+    switch ( target_bpp )
+    {
+        case 1: return (pixels[x + (y / 8) * s_width] >> (y & 0x07)) & 0x01;
+        case 4: return (pixels[x / 2 + y * s_width / 2] >> ((x & 1) * 4)) & 0x0F;
+        case 8: return pixels[x + y * s_width];
+        case 16: return ((const uint16_t *)pixels)[x + y * s_width];
+        case 32: return ((const uint32_t *)pixels)[x + y * s_width];
+        default: return 0;
+    }
+}
+
+static void add_diff_pixel( sdl_pixels_diff *diff, int x, int y )
+{
+    int i;
+    /* Join pixels, located close to existing area */
+    for (i = 0; i < diff->areas; i++)
+    {
+        sdl_diff_area *a = &diff->area[i];
+        if ( x >= a->x1 - SDL_DIFF_AREA_GAP && x <= a->x2 + SDL_DIFF_AREA_GAP &&
+             y >= a->y1 - SDL_DIFF_AREA_GAP && y <= a->y2 + SDL_DIFF_AREA_GAP )
+        {
+            break;
+        }
+    }
+    if ( i == diff->areas )
+    {
+        if ( diff->areas < SDL_DIFF_MAX_AREAS )
+        {
+            diff->area[diff->areas].x1 = diff->area[diff->areas].x2 = x;
+            diff->area[diff->areas].y1 = diff->area[diff->areas].y2 = y;
+            diff->areas++;
+            return;
+        }
+        /* No free areas, extend the last one */
+        i = diff->areas - 1;
+    }
+    sdl_diff_area *a = &diff->area[i];
+    if ( x < a->x1 ) a->x1 = x;
+    if ( x > a->x2 ) a->x2 = x;
+    if ( y < a->y1 ) a->y1 = y;
+    if ( y > a->y2 ) a->y2 = y;
+}
+
+int sdl_core_diff_pixels_data( const uint8_t *reference, uint8_t target_bpp, sdl_pixels_diff *diff )
+{
+    int len = sdl_core_get_pixels_len( target_bpp );
+    uint8_t *pixels = malloc( len > 0 ? len : 1 );
+    if ( !pixels )
+    {
+        return -1;
+    }
+    memset( diff, 0, sizeof(*diff) );
+    sdl_core_get_pixels_data( pixels, target_bpp );
+    for (int y = 0; y < s_height; y++)
+    {
+        for (int x = 0; x < s_width; x++)
         {
-            uint32_t pixel = sdl_get_pixel( x, y );
-            pixel = convert_pixel( pixel, target_bpp );
-            switch ( target_bpp )
+            if ( get_target_pixel( pixels, x, y, target_bpp ) != get_target_pixel( reference, x, y, target_bpp ) )
             {
-                case 1: ((uint8_t *)pixels)[x + (y / 8)*s_width] |= (pixel << (y & 0x7));  break;
-                case 4: ((uint8_t *)pixels)[x / 2 + y * s_width / 2] |= (pixel << ((x & 1) * 4)); break;
-                case 8: ((uint8_t *)pixels)[x + y * s_width] = pixel; break;
-                case 16: ((uint16_t *)pixels)[x + y * s_width] = pixel; break;
-                case 32: ((uint32_t *)pixels)[x + y * s_width] = pixel; break;
-                default: break;
+                if ( !diff->count )
+                {
+                    diff->bounds.x1 = diff->bounds.x2 = x;
+                    diff->bounds.y1 = diff->bounds.y2 = y;
+                }
+                if ( x < diff->bounds.x1 ) diff->bounds.x1 = x;
+                if ( x > diff->bounds.x2 ) diff->bounds.x2 = x;
+                if ( y > diff->bounds.y2 ) diff->bounds.y2 = y;
+                diff->count++;
+                add_diff_pixel( diff, x, y );
             }
         }
+    }
+    free( pixels );
+    /* Areas could grow to overlap each other, merge them */
+    for (int i = 0; i < diff->areas; i++)
+    {
+        for (int j = i + 1; j < diff->areas; j++)
+        {
+            sdl_diff_area *a = &diff->area[i];
+            sdl_diff_area *b = &diff->area[j];
+            if ( b->x1 <= a->x2 + SDL_DIFF_AREA_GAP && b->x2 >= a->x1 - SDL_DIFF_AREA_GAP &&
+                 b->y1 <= a->y2 + SDL_DIFF_AREA_GAP && b->y2 >= a->y1 - SDL_DIFF_AREA_GAP )
+            {
+                if ( b->x1 < a->x1 ) a->x1 = b->x1;
+                if ( b->x2 > a->x2 ) a->x2 = b->x2;
+                if ( b->y1 < a->y1 ) a->y1 = b->y1;
+                if ( b->y2 > a->y2 ) a->y2 = b->y2;
+                diff->area[j] = diff->area[--diff->areas];
+                j = i;
+            }
+        }
+    }
+    return diff->count;
 }
 
 int sdl_core_get_pixels_len( uint8_t target_bpp )
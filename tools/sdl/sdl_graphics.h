@@ -37,6 +37,12 @@ extern void sdl_graphics_close(void);
 
 extern void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfmt);
 extern void sdl_put_pixel(int x, int y, uint32_t color);
+/**
+ * Writes run of pixels to the row y, starting at column x and moving by dx (1 or -1)
+ * after each pixel. Pixels are in controller format: 8-bit pixels one byte each,
+ * 16-bit pixels most significant byte first.
+ */
+extern void sdl_put_pixels(int x, int y, int dx, const uint8_t *data, int count);
 extern uint32_t sdl_get_pixel(int x, int y);
 
 #ifdef __cplusplus
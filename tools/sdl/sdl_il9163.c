@@ -34,11 +34,14 @@ static int s_columnEnd = 127;
 static int s_pageStart = 0;
 static int s_pageEnd = 7;
 static uint8_t detected = 0;
+static uint8_t s_firstByte = 1;
+static uint8_t s_dataFirst = 0x00;
 static uint8_t s_lcd_type;
 
 static void sdl_il9163_reset(void)
 {
     detected = 0;
+    s_firstByte = 1;
 }
 
 static int sdl_il9163_detect(uint8_t data)
@@ -197,15 +200,13 @@ void sdl_il9163_data(uint8_t data)
 {
     int y = s_activePage;
     int x = s_activeColumn;
-    static uint8_t firstByte = 1;  /// il9163
-    static uint8_t dataFirst = 0x00;  /// il9163
-    if (firstByte)
+    if (s_firstByte)
     {
-        dataFirst = data;
-        firstByte = 0;
+        s_dataFirst = data;
+        s_firstByte = 0;
         return;
     }
-    firstByte = 1;
+    s_firstByte = 1;
     int rx, ry;
     if (s_verticalMode & 0b00100000)
     {
@@ -217,7 +218,7 @@ void sdl_il9163_data(uint8_t data)
         rx = (s_verticalMode & 0b10000000) ? (sdl_il9163.width - 1 - x) : x;
         ry = (s_verticalMode & 0b01000000) ? (sdl_il9163.height - 1 - y) : y;
     }
-    sdl_put_pixel(rx, ry, (dataFirst<<8) | data);
+    sdl_put_pixel(rx, ry, (s_dataFirst<<8) | data);
 
     if (s_verticalMode & 0b00100000)
     {
@@ -247,6 +248,49 @@ void sdl_il9163_data(uint8_t data)
     }
 }
 
+static void sdl_il9163_data_block(const uint8_t *data, int size)
+{
+    if ( s_verticalMode & 0b00100000 )
+    {
+        while ( size-- > 0 ) sdl_il9163_data( *data++ );
+        return;
+    }
+    if ( !s_firstByte && size > 0 )
+    {
+        sdl_il9163_data( *data++ );
+        size--;
+    }
+    while ( size >= 2 )
+    {
+        int count = s_columnEnd - s_activeColumn + 1;
+        if ( count <= 0 )
+        {
+            for (int i = 0; i < 2; i++) sdl_il9163_data( *data++ );
+            size -= 2;
+            continue;
+        }
+        if ( count > size / 2 ) count = size / 2;
+        int x = s_activeColumn;
+        int y = s_activePage;
+        sdl_put_pixels( (s_verticalMode & 0b10000000) ? (sdl_il9163.width - 1 - x) : x,
+                        (s_verticalMode & 0b01000000) ? (sdl_il9163.height - 1 - y) : y,
+                        (s_verticalMode & 0b10000000) ? -1 : 1, data, count );
+        data += count * 2;
+        size -= count * 2;
+        s_activeColumn += count;
+        if (s_activeColumn > s_columnEnd)
+        {
+            s_activeColumn = s_columnStart;
+            s_activePage++;
+            if (s_activePage > s_pageEnd)
+            {
+                s_activePage = s_pageStart;
+            }
+        }
+    }
+    while ( size-- > 0 ) sdl_il9163_data( *data++ );
+}
+
 sdl_oled_info sdl_il9163 =
 {
     .width = 128,
@@ -257,5 +301,6 @@ sdl_oled_info sdl_il9163 =
     .detect = sdl_il9163_detect,
     .run_cmd = sdl_il9163_commands,
     .run_data = sdl_il9163_data,
+    .run_data_block = sdl_il9163_data_block,
     .reset = sdl_il9163_reset,
 };
@@ -34,6 +34,14 @@ static int s_columnEnd = 127;
 static int s_pageStart = 0;
 static int s_pageEnd = 7;
 static uint8_t detected = 0;
+static uint8_t s_firstByte = 1;
+static uint8_t s_dataFirst = 0x00;
+
+static void sdl_ili9341_reset(void)
+{
+    detected = 0;
+    s_firstByte = 1;
+}
 
 static int sdl_ili9341_detect(uint8_t data)
 {
@@ -180,15 +188,13 @@ void sdl_ili9341_data(uint8_t data)
 {
     int y = s_activePage;
     int x = s_activeColumn;
-    static uint8_t firstByte = 1;  /// ili9341
-    static uint8_t dataFirst = 0x00;  /// ili9341
-    if (firstByte)
+    if (s_firstByte)
     {
-        dataFirst = data;
-        firstByte = 0;
+        s_dataFirst = data;
+        s_firstByte = 0;
         return;
     }
-    firstByte = 1;
+    s_firstByte = 1;
     int rx, ry;
     if (s_verticalMode & 0b00100000)
     {
@@ -200,7 +206,7 @@ void sdl_ili9341_data(uint8_t data)
         rx = (s_verticalMode & 0b10000000) ? x: (sdl_ili9341.width - 1 - x);
         ry = (s_verticalMode & 0b01000000) ? (sdl_ili9341.height - 1 - y) : y;
     }
-    sdl_put_pixel(rx, ry, (dataFirst<<8) | data);
+    sdl_put_pixel(rx, ry, (s_dataFirst<<8) | data);
 
     if (s_verticalMode & 0b00100000)
     {
@@ -230,6 +236,49 @@ void sdl_ili9341_data(uint8_t data)
     }
 }
 
+static void sdl_ili9341_data_block(const uint8_t *data, int size)
+{
+    if ( s_verticalMode & 0b00100000 )
+    {
+        while ( size-- > 0 ) sdl_ili9341_data( *data++ );
+        return;
+    }
+    if ( !s_firstByte && size > 0 )
+    {
+        sdl_ili9341_data( *data++ );
+        size--;
+    }
+    while ( size >= 2 )
+    {
+        int count = s_columnEnd - s_activeColumn + 1;
+        if ( count <= 0 )
+        {
+            for (int i = 0; i < 2; i++) sdl_ili9341_data( *data++ );
+            size -= 2;
+            continue;
+        }
+        if ( count > size / 2 ) count = size / 2;
+        int x = s_activeColumn;
+        int y = s_activePage;
+        sdl_put_pixels( (s_verticalMode & 0b10000000) ? x : (sdl_ili9341.width - 1 - x),
+                        (s_verticalMode & 0b01000000) ? (sdl_ili9341.height - 1 - y) : y,
+                        (s_verticalMode & 0b10000000) ? 1 : -1, data, count );
+        data += count * 2;
+        size -= count * 2;
+        s_activeColumn += count;
+        if (s_activeColumn > s_columnEnd)
+        {
+            s_activeColumn = s_columnStart;
+            s_activePage++;
+            if (s_activePage > s_pageEnd)
+            {
+                s_activePage = s_pageStart;
+            }
+        }
+    }
+    while ( size-- > 0 ) sdl_ili9341_data( *data++ );
+}
+
 sdl_oled_info sdl_ili9341 =
 {
     .width = 240,
@@ -240,4 +289,6 @@ sdl_oled_info sdl_ili9341 =
     .detect = sdl_ili9341_detect,
     .run_cmd = sdl_ili9341_commands,
     .run_data = sdl_ili9341_data,
+    .reset = sdl_ili9341_reset,
+    .run_data_block = sdl_ili9341_data_block,
 };
@@ -64,6 +64,8 @@ typedef struct
     void  (*run_cmd)(uint8_t data);
     void  (*run_data)(uint8_t data);
     void  (*reset)(void);
+    /** Optional: writes block of display data at once. If NULL, run_data is used */
+    void  (*run_data_block)(const uint8_t *data, int size);
 } sdl_oled_info;
 
 #if defined(SDL_NO_BORDER)
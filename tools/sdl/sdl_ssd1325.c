@@ -56,6 +56,11 @@ static void copyBlock()
     }
 }
 
+static void sdl_ssd1325_reset(void)
+{
+    detected = 0;
+}
+
 static int sdl_ssd1325_detect(uint8_t data)
 {
     if (detected)
@@ -249,4 +254,5 @@ sdl_oled_info sdl_ssd1325 =
     .detect = sdl_ssd1325_detect,
     .run_cmd = sdl_ssd1325_commands,
     .run_data = sdl_ssd1325_data,
+    .reset = sdl_ssd1325_reset,
 };
@@ -45,6 +45,8 @@ static uint8_t s_topToBottom = 0;
 static uint8_t s_16bitmode = 0;
 static uint8_t detected_x8 = 0;
 static uint8_t detected_x16 = 0;
+static uint8_t s_firstByte = 1;
+static uint8_t s_dataFirst = 0x00;
 
 static void copyBlock()
 {
@@ -98,6 +100,7 @@ static void sdl_ssd1331_reset(void)
 {
     detected_x8 = 0;
     detected_x16 = 0;
+    s_firstByte = 1;
 }
 
 static int sdl_ssd1331_detect_x8(uint8_t data)
@@ -221,18 +224,16 @@ static void sdl_ssd1331_data(uint8_t data)
 {
     int y = s_topToBottom ? s_activePage : (sdl_ssd1331x8.height - s_activePage - 1);
     int x = s_leftToRight ? s_activeColumn: (sdl_ssd1331x8.width - s_activeColumn - 1);
-    static uint8_t firstByte = 1;  /// SSD1331
-    static uint8_t dataFirst = 0x00;  /// SSD1331
-    if (firstByte && s_16bitmode)
+    if (s_firstByte && s_16bitmode)
     {
-        dataFirst = data;
-        firstByte = 0;
+        s_dataFirst = data;
+        s_firstByte = 0;
         return;
     }
-    firstByte = 1;
+    s_firstByte = 1;
     if ( s_16bitmode )
     {
-        sdl_put_pixel(x, y, (dataFirst<<8) | data);
+        sdl_put_pixel(x, y, (s_dataFirst<<8) | data);
     }
     else
     {
@@ -267,6 +268,50 @@ static void sdl_ssd1331_data(uint8_t data)
     }
 }
 
+static void sdl_ssd1331_data_block(const uint8_t *data, int size)
+{
+    int bpp = s_16bitmode ? 2 : 1;
+    if ( s_verticalMode )
+    {
+        while ( size-- > 0 ) sdl_ssd1331_data( *data++ );
+        return;
+    }
+    if ( !s_firstByte && size > 0 )
+    {
+        sdl_ssd1331_data( *data++ );
+        size--;
+    }
+    while ( size >= bpp )
+    {
+        int count = s_columnEnd - s_activeColumn + 1;
+        if ( count <= 0 )
+        {
+            for (int i = 0; i < bpp; i++) sdl_ssd1331_data( *data++ );
+            size -= bpp;
+            continue;
+        }
+        if ( count > size / bpp ) count = size / bpp;
+        int x = s_activeColumn;
+        int y = s_activePage;
+        sdl_put_pixels( s_leftToRight ? x : (sdl_ssd1331x8.width - x - 1),
+                        s_topToBottom ? y : (sdl_ssd1331x8.height - y - 1),
+                        s_leftToRight ? 1 : -1, data, count );
+        data += count * bpp;
+        size -= count * bpp;
+        s_activeColumn += count;
+        if (s_activeColumn > s_columnEnd)
+        {
+            s_activeColumn = s_columnStart;
+            s_activePage++;
+            if (s_activePage > s_pageEnd)
+            {
+                s_activePage = s_pageStart;
+            }
+        }
+    }
+    while ( size-- > 0 ) sdl_ssd1331_data( *data++ );
+}
+
 sdl_oled_info sdl_ssd1331x8 =
 {
     .width = 96,
@@ -278,6 +323,7 @@ sdl_oled_info sdl_ssd1331x8 =
     .run_cmd = sdl_ssd1331_commands,
     .run_data = sdl_ssd1331_data,
     .reset = sdl_ssd1331_reset,
+    .run_data_block = sdl_ssd1331_data_block,
 };
 
 sdl_oled_info sdl_ssd1331x16 =
@@ -291,5 +337,6 @@ sdl_oled_info sdl_ssd1331x16 =
     .run_cmd = sdl_ssd1331_commands,
     .run_data = sdl_ssd1331_data,
     .reset = sdl_ssd1331_reset,
+    .run_data_block = sdl_ssd1331_data_block,
 };
 
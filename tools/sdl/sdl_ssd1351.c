@@ -37,8 +37,16 @@ static uint8_t s_incrementMode = 0;
 static uint8_t s_topToBottom = 0;
 static uint8_t s_leftToRight = 0;
 static uint8_t detected = 0;
+static uint8_t s_firstByte = 1;
+static uint8_t s_dataFirst = 0x00;
 
 
+static void sdl_ssd1351_reset(void)
+{
+    detected = 0;
+    s_firstByte = 1;
+}
+
 static int sdl_ssd1351_detect(uint8_t data)
 {
     if (detected)
@@ -121,16 +129,14 @@ void sdl_ssd1351_data(uint8_t data)
 {
     int y = s_topToBottom ? s_activePage : (sdl_ssd1351.height - s_activePage - 1);
     int x = s_leftToRight ? (sdl_ssd1351.width - s_activeColumn - 1) : s_activeColumn;
-    static uint8_t firstByte = 1;  /// SSD1351
-    static uint8_t dataFirst = 0x00;  /// SSD1351
-    if (firstByte)
+    if (s_firstByte)
     {
-        dataFirst = data;
-        firstByte = 0;
+        s_dataFirst = data;
+        s_firstByte = 0;
         return;
     }
-    firstByte = 1;
-    sdl_put_pixel(x, y, (dataFirst<<8) | data);
+    s_firstByte = 1;
+    sdl_put_pixel(x, y, (s_dataFirst<<8) | data);
 
     if (s_incrementMode)
     {
@@ -160,6 +166,49 @@ void sdl_ssd1351_data(uint8_t data)
     }
 }
 
+static void sdl_ssd1351_data_block(const uint8_t *data, int size)
+{
+    if ( s_incrementMode )
+    {
+        while ( size-- > 0 ) sdl_ssd1351_data( *data++ );
+        return;
+    }
+    if ( !s_firstByte && size > 0 )
+    {
+        sdl_ssd1351_data( *data++ );
+        size--;
+    }
+    while ( size >= 2 )
+    {
+        int count = s_columnEnd - s_activeColumn + 1;
+        if ( count <= 0 )
+        {
+            for (int i = 0; i < 2; i++) sdl_ssd1351_data( *data++ );
+            size -= 2;
+            continue;
+        }
+        if ( count > size / 2 ) count = size / 2;
+        int x = s_activeColumn;
+        int y = s_activePage;
+        sdl_put_pixels( s_leftToRight ? (sdl_ssd1351.width - x - 1) : x,
+                        s_topToBottom ? y : (sdl_ssd1351.height - y - 1),
+                        s_leftToRight ? -1 : 1, data, count );
+        data += count * 2;
+        size -= count * 2;
+        s_activeColumn += count;
+        if (s_activeColumn > s_columnEnd)
+        {
+            s_activeColumn = s_columnStart;
+            s_activePage++;
+            if (s_activePage > s_pageEnd)
+            {
+                s_activePage = s_pageStart;
+            }
+        }
+    }
+    while ( size-- > 0 ) sdl_ssd1351_data( *data++ );
+}
+
 sdl_oled_info sdl_ssd1351 =
 {
     .width = 128,
@@ -170,4 +219,6 @@ sdl_oled_info sdl_ssd1351 =
     .detect = sdl_ssd1351_detect,
     .run_cmd = sdl_ssd1351_commands,
     .run_data = sdl_ssd1351_data,
+    .reset = sdl_ssd1351_reset,
+    .run_data_block = sdl_ssd1351_data_block,
 };
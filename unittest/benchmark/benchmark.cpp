@@ -0,0 +1,257 @@
+/*
+    MIT License
+
+    Copyright (c) 2020, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Headless benchmark of display drivers. Each display is connected to the SDL
+ * emulator, running in unittest mode (no window is created), via InterfaceStats
+ * wrapper. Every workload is repeated for the specified time, and the tool
+ * prints average time per operation, bytes and transactions sent to the
+ * bus per operation, and bus transfer time per operation, calculated by the
+ * emulator timing model (8 MHz spi, 400 kHz i2c by default).
+ *
+ * Usage: benchmark [-c] [-t ms] [filter]
+ *    -c       print results in csv format
+ *    -t ms    minimum time to run each workload (default 20 ms)
+ *    filter   run only displays, which names contain the filter string
+ */
+
+#include "lcdgfx.h"
+#include "sdl_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(CONFIG_INTERFACE_STATS_DISABLE)
+#error "benchmark requires InterfaceStats, do not define CONFIG_INTERFACE_STATS_DISABLE"
+#endif
+
+typedef InterfaceStats<PlatformSpi> BenchSpi;
+typedef InterfaceStats<PlatformI2c> BenchI2c;
+
+static const SPlatformSpiConfig s_spiConfig = { -1, { 0 }, 1, 0, -1, -1 };
+static const SPlatformI2cConfig s_i2cConfig = { -1, 0x3C, -1, -1, 0 };
+
+static bool s_csv = false;
+static uint64_t s_minTimeNs = 20000000;
+static const char *s_filter = nullptr;
+
+/* 32x32 monochrome bitmap in native display format */
+static uint8_t s_bitmap[32 * 32 / 8];
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void printResult(const char *display, const char *workload, uint32_t ops,
+                        uint64_t ns, const SInterfaceStats &stats, uint32_t busUs)
+{
+    uint64_t nsPerOp = ns / ops;
+    double bytesPerOp = (double)stats.bytes / ops;
+    double transactionsPerOp = (double)stats.starts / ops;
+    double busUsPerOp = (double)busUs / ops;
+    if ( s_csv )
+    {
+        printf( "%s,%s,%u,%llu,%.1f,%.1f,%.1f\n", display, workload, ops,
+                (unsigned long long)nsPerOp, bytesPerOp, transactionsPerOp, busUsPerOp );
+    }
+    else
+    {
+        printf( "%-36s %-8s %8u %12llu %12.1f %8.1f %12.1f\n", display, workload, ops,
+                (unsigned long long)nsPerOp, bytesPerOp, transactionsPerOp, busUsPerOp );
+    }
+}
+
+template <class D, class F>
+static void measure(const char *name, const char *workload, D &display, F op)
+{
+    /* warm up, first call can include one-time initialization */
+    op();
+    display.getInterface().resetStats();
+    sdl_core_reset_bus_time();
+    uint32_t ops = 0;
+    uint64_t start = nowNs();
+    uint64_t elapsed;
+    do
+    {
+        op();
+        ops++;
+        elapsed = nowNs() - start;
+    } while ( elapsed < s_minTimeNs );
+    printResult( name, workload, ops, elapsed, display.getInterface().getStats(),
+                 sdl_core_get_bus_time_us() );
+}
+
+template <class E>
+struct EngineScene
+{
+    static E *engine;
+    static uint16_t color;
+
+    static bool draw()
+    {
+        engine->getCanvas().setColor( color );
+        engine->getCanvas().fillRect( 8, 8, 39, 23 );
+        engine->getCanvas().drawRect( 16, 16, 71, 47 );
+        engine->getCanvas().drawLine( 0, 0, 127, 63 );
+        engine->getCanvas().printFixed( 4, 40, "Engine", STYLE_NORMAL );
+        return true;
+    }
+};
+
+template <class E>
+E *EngineScene<E>::engine = nullptr;
+
+template <class E>
+uint16_t EngineScene<E>::color = 0;
+
+template <class D>
+static void benchmark(const char *name, D &display)
+{
+    if ( s_filter && !strstr( name, s_filter ) )
+    {
+        return;
+    }
+    const uint8_t bpp = D::BITS_PER_PIXEL;
+    const uint16_t color = bpp >= 16 ? 0xFFFF : (uint16_t)( ( 1u << bpp ) - 1 );
+    display.begin();
+    display.setFixedFont( ssd1306xled_font6x8 );
+    display.setColor( color );
+
+    measure( name, "clear", display, [&]() { display.clear(); } );
+    measure( name, "fill", display, [&]()
+        {
+            display.fillRect( display.width() / 4, display.height() / 4,
+                              display.width() * 3 / 4 - 1, display.height() * 3 / 4 - 1 );
+        } );
+    measure( name, "text", display, [&]()
+        {
+            display.printFixed( 0, 8, "Benchmark 0123456789", STYLE_NORMAL );
+        } );
+    measure( name, "bitmap", display, [&]()
+        {
+            display.drawBitmap1( 16, 16, 32, 32, s_bitmap );
+        } );
+
+    NanoCanvas<32, 32, D::BITS_PER_PIXEL> canvas;
+    canvas.setColor( color );
+    canvas.setFixedFont( ssd1306xled_font6x8 );
+    canvas.drawRect( 0, 0, 31, 31 );
+    canvas.fillRect( 4, 4, 15, 15 );
+    canvas.printFixed( 2, 20, "Cnv", STYLE_NORMAL );
+    measure( name, "canvas", display, [&]() { display.drawCanvas( 16, 16, canvas ); } );
+
+    typedef NanoEngine<NanoCanvas<16, 16, D::BITS_PER_PIXEL>, D> Engine;
+    Engine engine( display );
+    engine.begin();
+    engine.getCanvas().setFixedFont( ssd1306xled_font6x8 );
+    EngineScene<Engine>::engine = &engine;
+    EngineScene<Engine>::color = color;
+    engine.drawCallback( EngineScene<Engine>::draw );
+    measure( name, "engine", display, [&]()
+        {
+            engine.refresh();
+            engine.display();
+        } );
+
+    display.end();
+}
+
+/* Declares display of specified type and runs all workloads on it */
+#define BENCHMARK_SPI(type) \
+    { \
+        type<BenchSpi> display( -1, s_spiConfig.dc, s_spiConfig ); \
+        benchmark( #type, display ); \
+    }
+
+#define BENCHMARK_I2C(type) \
+    { \
+        type<BenchI2c> display( -1, s_i2cConfig ); \
+        benchmark( #type, display ); \
+    }
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ( ( opt = getopt( argc, argv, "ct:" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'c': s_csv = true; break;
+            case 't': s_minTimeNs = (uint64_t)strtoul( optarg, nullptr, 10 ) * 1000000u; break;
+            default:
+                fprintf( stderr, "Usage: %s [-c] [-t ms] [filter]\n", argv[0] );
+                return 1;
+        }
+    }
+    if ( optind < argc )
+    {
+        s_filter = argv[optind];
+    }
+    for (unsigned i = 0; i < sizeof(s_bitmap); i++)
+    {
+        s_bitmap[i] = (uint8_t)( i * 37 + ( i >> 3 ) );
+    }
+
+    sdl_core_set_unittest_mode();
+    if ( s_csv )
+    {
+        printf( "display,workload,ops,ns_per_op,bytes_per_op,transactions_per_op,bus_us_per_op\n" );
+    }
+    else
+    {
+        printf( "%-36s %-8s %8s %12s %12s %8s %12s\n", "display", "workload", "ops",
+                "ns/op", "bytes/op", "trans/op", "bus us/op" );
+    }
+
+    BENCHMARK_SPI( DisplayIL9163_128x128x16_CustomSPI );
+    BENCHMARK_SPI( DisplayIL9163_128x160x16_CustomSPI );
+    BENCHMARK_SPI( DisplayILI9341_128x160x16_CustomSPI );
+    BENCHMARK_SPI( DisplayILI9341_240x320x16_CustomSPI );
+    BENCHMARK_SPI( DisplayPCD8544_84x48_CustomSPI );
+    BENCHMARK_SPI( DisplaySH1106_128x64_CustomSPI );
+    BENCHMARK_I2C( DisplaySH1106_128x64_CustomI2C );
+    BENCHMARK_SPI( DisplaySH1107_128x64_CustomSPI );
+    BENCHMARK_I2C( DisplaySH1107_128x64_CustomI2C );
+    BENCHMARK_SPI( DisplaySH1107_64x128_CustomSPI );
+    BENCHMARK_I2C( DisplaySH1107_64x128_CustomI2C );
+    BENCHMARK_SPI( DisplaySSD1306_128x32_CustomSPI );
+    BENCHMARK_I2C( DisplaySSD1306_128x32_CustomI2C );
+    BENCHMARK_SPI( DisplaySSD1306_128x64_CustomSPI );
+    BENCHMARK_I2C( DisplaySSD1306_128x64_CustomI2C );
+    BENCHMARK_SPI( DisplaySSD1325_128x64_CustomSPI );
+    BENCHMARK_I2C( DisplaySSD1325_128x64_CustomI2C );
+    BENCHMARK_SPI( DisplaySSD1327_128x128_CustomSPI );
+    BENCHMARK_I2C( DisplaySSD1327_128x128_CustomI2C );
+    BENCHMARK_SPI( DisplaySSD1331_96x64x8_CustomSPI );
+    BENCHMARK_SPI( DisplaySSD1331_96x64x16_CustomSPI );
+    BENCHMARK_SPI( DisplaySSD1351_128x128x16_CustomSPI );
+    BENCHMARK_SPI( DisplayST7735_128x128x16_CustomSPI );
+    BENCHMARK_SPI( DisplayST7735_128x160x16_CustomSPI );
+    return 0;
+}
@@ -26,6 +26,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <string>
 #include <vector>
 #include "lcdgfx.h"
 #include "sdl_core.h"
@@ -69,8 +71,618 @@ TEST(SSD1306, monochrome_test)
 //    print_screen_content( pixels.data(), sdl_core_get_pixels_len( 1 ), 1, 128 );
 
     CHECK_EQUAL( sizeof(monochrome_test_data), pixels.size() );
-    MEMCMP_EQUAL( monochrome_test_data, pixels.data(), sizeof(monochrome_test_data));
+    CHECK( check_screen_content( monochrome_test_data, 1 ) );
 
     display.end();
 }
 
+
+TEST(SSD1306, diff_update_test)
+{
+    DisplaySSD1306_128x64_I2C display(-1);
+    NanoCanvas<128,64,1> canvas;
+    std::vector<uint8_t> front( 128 * 64 / 8, 0 );
+    display.begin();
+    display.clear();
+    canvas.setFixedFont(ssd1306xled_font6x8);
+    canvas.printFixed (0,  8, "12:00:00", STYLE_NORMAL);
+    canvas.drawRect (2, 30, 100, 50);
+    display.drawBuffer1Diff(0, 0, 128, 64, canvas.getData(), front.data());
+    canvas.printFixed (0,  8, "12:00:01", STYLE_NORMAL);
+    canvas.drawRect (4, 32, 98, 48);
+    display.drawBuffer1Diff(0, 0, 128, 64, canvas.getData(), front.data());
+
+    std::vector<uint8_t> pixels( sdl_core_get_pixels_len( 1 ), 0 );
+    sdl_core_get_pixels_data( pixels.data(), 1 );
+
+    CHECK_EQUAL( front.size(), pixels.size() );
+    MEMCMP_EQUAL( canvas.getData(), front.data(), front.size() );
+    MEMCMP_EQUAL( canvas.getData(), pixels.data(), pixels.size() );
+
+    display.end();
+}
+
+TEST(SSD1306, canvas_fill_test)
+{
+    NanoCanvas<72,40,1> canvas;
+    NanoCanvas<72,40,1> expected;
+    canvas.setOffset( 3, 5 );
+    expected.setOffset( 3, 5 );
+    srand( 1 );
+    for (int i = 0; i < 200; i++)
+    {
+        lcdint_t x1 = rand() % 90 - 10;
+        lcdint_t y1 = rand() % 60 - 10;
+        lcdint_t x2 = rand() % 90 - 10;
+        lcdint_t y2 = i % 10 ? rand() % 60 - 10 : y1;
+        uint16_t color = i & 1 ? WHITE : BLACK;
+        canvas.setColor( color );
+        expected.setColor( color );
+        if ( y1 == y2 )
+        {
+            canvas.drawHLine( x1, y1, x2 );
+        }
+        else
+        {
+            canvas.fillRect( x1, y1, x2, y2 );
+        }
+        for (lcdint_t y = min(y1, y2); y <= max(y1, y2); y++)
+        {
+            for (lcdint_t x = min(x1, x2); x <= max(x1, x2); x++)
+            {
+                expected.putPixel( x, y );
+            }
+        }
+        MEMCMP_EQUAL( expected.getData(), canvas.getData(), 72 * 40 / 8 );
+    }
+    /* Full width rectangle fills the middle banks at once */
+    canvas.setColor( WHITE );
+    canvas.fillRect( 3, 7, 74, 42 );
+    expected.setColor( WHITE );
+    for (lcdint_t y = 7; y <= 42; y++)
+    {
+        for (lcdint_t x = 3; x <= 74; x++)
+        {
+            expected.putPixel( x, y );
+        }
+    }
+    MEMCMP_EQUAL( expected.getData(), canvas.getData(), 72 * 40 / 8 );
+}
+
+TEST(SSD1306, canvas_bitmap_test)
+{
+    NanoCanvas<72,40,1> canvas;
+    NanoCanvas<72,40,1> expected;
+    uint8_t bitmap[20 * 3];
+    srand( 2 );
+    for (auto &data: bitmap) data = rand();
+    for (int i = 0; i < 200; i++)
+    {
+        lcdint_t x = rand() % 100 - 25;
+        lcdint_t y = rand() % 70 - 25;
+        lcduint_t w = rand() % 20 + 1;
+        lcduint_t h = (rand() % 3 + 1) * 8;
+        /* All combinations of WHITE/BLACK color and opaque/transparent mode. *
+         * BLACK opaque mode draws inverted bitmap                            */
+        uint8_t mode = i & 1 ? CANVAS_MODE_TRANSPARENT : 0;
+        uint16_t color = i & 2 ? BLACK : WHITE;
+        canvas.setMode( mode );
+        canvas.setColor( color );
+        canvas.drawBitmap1( x, y, w, h, bitmap );
+        for (lcduint_t by = 0; by < h; by++)
+        {
+            for (lcduint_t bx = 0; bx < w; bx++)
+            {
+                bool set = bitmap[(by / 8) * w + bx] & (1 << (by & 0x07));
+                if ( !set && mode == CANVAS_MODE_TRANSPARENT )
+                {
+                    continue;
+                }
+                expected.setColor( set == (color == WHITE) ? WHITE : BLACK );
+                expected.putPixel( x + bx, y + by );
+            }
+        }
+        MEMCMP_EQUAL( expected.getData(), canvas.getData(), 72 * 40 / 8 );
+    }
+}
+
+template <uint8_t BPP>
+static uint16_t canvas_pixel(NanoCanvasOps<BPP> &canvas, lcdint_t x, lcdint_t y)
+{
+    const uint8_t *data = canvas.getData();
+    switch ( BPP )
+    {
+        case 1: return (data[x + (y / 8) * canvas.width()] >> (y & 0x07)) & 0x01;
+        case 4: return (data[(x + y * canvas.width()) / 2] >> ((x & 1) * 4)) & 0x0F;
+        case 8: return data[x + y * canvas.width()];
+        default: return (data[(x + y * canvas.width()) * 2] << 8) | data[(x + y * canvas.width()) * 2 + 1];
+    }
+}
+
+template <uint8_t BPP>
+static void check_canvas_clip()
+{
+    NanoCanvas<64,40,BPP> clipped;
+    NanoCanvas<64,40,BPP> full;
+    NanoCanvas<64,40,BPP> origin;
+    uint8_t bitmap[24 * 24];
+    srand( 3 );
+    for (auto &data: bitmap) data = rand();
+    for (int i = 0; i < 100; i++)
+    {
+        lcdint_t ox = rand() % 9 - 4;
+        lcdint_t oy = rand() % 9 - 4;
+        clipped.setOffset( ox, oy );
+        full.setOffset( ox, oy );
+        NanoRect area = { { (lcdint_t)(rand() % 70 - 5), (lcdint_t)(rand() % 50 - 5) },
+                          { (lcdint_t)(rand() % 70 - 5), (lcdint_t)(rand() % 50 - 5) } };
+        CHECK( clipped.pushClip( { { -100, -100 }, { 100, 100 } } ) );
+        CHECK( clipped.pushClip( area ) );
+        uint16_t color = rand();
+        if ( BPP == 1 ) color = color & 1 ? WHITE : BLACK;
+        uint8_t mode = rand() & 1 ? CANVAS_MODE_TRANSPARENT : 0;
+        lcdint_t x1 = rand() % 80 - 10, y1 = rand() % 60 - 10;
+        lcdint_t x2 = rand() % 80 - 10, y2 = rand() % 60 - 10;
+        int op = rand() % 7;
+        for (NanoCanvasOps<BPP> *canvas: { (NanoCanvasOps<BPP> *)&clipped, (NanoCanvasOps<BPP> *)&full })
+        {
+            canvas->setColor( color );
+            canvas->setMode( mode );
+            switch ( op )
+            {
+                case 0: canvas->putPixel( x1, y1 ); break;
+                case 1: canvas->drawHLine( x1, y1, x2 ); break;
+                case 2: canvas->drawVLine( x1, y1, y2 ); break;
+                case 3: canvas->fillRect( x1, y1, x2, y2 ); break;
+                case 4: canvas->drawBitmap1( x1, y1, 24, 24, bitmap ); break;
+                case 5: canvas->drawLine( x1, y1, x2, y2 ); break;
+                default: canvas->drawCircle( x1, y1, x2 & 0x1F ); break;
+            }
+        }
+        for (lcdint_t y = 0; y < 40; y++)
+        {
+            for (lcdint_t x = 0; x < 64; x++)
+            {
+                bool inside = area.contains( NanoPoint{ (lcdint_t)(x + ox), (lcdint_t)(y + oy) } );
+                uint16_t expected = canvas_pixel<BPP>( inside ? full : origin, x, y );
+                CHECK_EQUAL( expected, canvas_pixel<BPP>( clipped, x, y ) );
+            }
+        }
+        clipped.popClip();
+        /* Outer clip area covers whole canvas */
+        CHECK( clipped.clipRect().p1 == clipped.rect().p1 && clipped.clipRect().p2 == clipped.rect().p2 );
+        clipped.popClip();
+        memcpy( clipped.getData(), full.getData(), 64 * 40 * BPP / 8 );
+        memcpy( origin.getData(), full.getData(), 64 * 40 * BPP / 8 );
+    }
+    for (int i = 0; i < CANVAS_CLIP_STACK_DEPTH; i++)
+    {
+        CHECK( clipped.pushClip( { { 10, 10 }, { 20, 20 } } ) );
+    }
+    CHECK( !clipped.pushClip( { { 10, 10 }, { 20, 20 } } ) );
+    /* Clip area is copied with other settings, and follows offset, changed after pushClip() */
+    NanoCanvas<64,40,BPP> copy;
+    full.setOffset( 0, 0 );
+    full.setColor( 0xFFFF );
+    full.pushClip( { { 5, 6 }, { 30, 20 } } );
+    copy.copySettings( full );
+    copy.setOffset( 3, 2 );
+    copy.fillRect( -10, -10, 100, 100 );
+    for (lcdint_t y = 0; y < 40; y++)
+    {
+        for (lcdint_t x = 0; x < 64; x++)
+        {
+            bool inside = x + 3 >= 5 && x + 3 <= 30 && y + 2 >= 6 && y + 2 <= 20;
+            CHECK_EQUAL( inside, canvas_pixel<BPP>( copy, x, y ) != 0 );
+        }
+    }
+    full.popClip();
+    copy.popClip();
+    /* Clip area follows offset, changed directly, as NanoEngine tiler does */
+    copy.clear();
+    copy.setOffset( 0, 0 );
+    copy.pushClip( { { 0, 0 }, { 9, 9 } } );
+    copy.offset += (NanoPoint){ 20, 0 };
+    copy.fillRect( 0, 0, 63, 39 );
+    copy.offset -= (NanoPoint){ 25, 0 };
+    copy.fillRect( 0, 0, 63, 39 );
+    for (lcdint_t y = 0; y < 40; y++)
+    {
+        for (lcdint_t x = 0; x < 64; x++)
+        {
+            bool inside = x >= 5 && x <= 14 && y <= 9;
+            CHECK_EQUAL( inside, canvas_pixel<BPP>( copy, x, y ) != 0 );
+        }
+    }
+    copy.popClip();
+}
+
+TEST(SSD1306, canvas_clip_test)
+{
+    check_canvas_clip<1>();
+    check_canvas_clip<4>();
+    check_canvas_clip<8>();
+    check_canvas_clip<16>();
+}
+
+template <uint8_t BPP>
+static void check_canvas_shapes()
+{
+    NanoCanvas<64,40,BPP> canvas;
+    NanoCanvas<64,40,BPP> reference;
+    canvas.setColor( 0xFFFF );
+    reference.setColor( 0xFFFF );
+    srand( 5 );
+    for (lcdint_t r = 1; r < 20; r++)
+    {
+        /* Filled circle covers its outline, and each row is filled between outline ends */
+        canvas.clear();
+        reference.clear();
+        canvas.fillCircle( 32, 20, r );
+        reference.drawCircle( 32, 20, r );
+        for (lcdint_t y = 0; y < 40; y++)
+        {
+            lcdint_t x1 = 64, x2 = -1;
+            for (lcdint_t x = 0; x < 64; x++)
+            {
+                if ( canvas_pixel<BPP>( reference, x, y ) )
+                {
+                    x1 = x1 < x ? x1 : x;
+                    x2 = x;
+                }
+            }
+            for (lcdint_t x = 0; x < 64; x++)
+            {
+                CHECK_EQUAL( x >= x1 && x <= x2, canvas_pixel<BPP>( canvas, x, y ) != 0 );
+            }
+        }
+    }
+    for (int i = 0; i < 200; i++)
+    {
+        NanoPoint p[4];
+        for (auto &point: p)
+        {
+            point = { (lcdint_t)(rand() % 80 - 8), (lcdint_t)(rand() % 56 - 8) };
+        }
+        canvas.setOffset( i % 5 - 2, i % 3 - 1 );
+        reference.setOffset( i % 5 - 2, i % 3 - 1 );
+        /* Triangle is special case of polygon */
+        canvas.clear();
+        reference.clear();
+        canvas.fillTriangle( p[0].x, p[0].y, p[1].x, p[1].y, p[2].x, p[2].y );
+        reference.fillPolygon( p, 3 );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+        /* Rectangle polygon and rounded rectangle with zero radius are the same as fillRect */
+        NanoPoint rect[4] = { p[0], { p[1].x, p[0].y }, p[1], { p[0].x, p[1].y } };
+        canvas.clear();
+        reference.clear();
+        canvas.fillPolygon( rect, 4 );
+        reference.fillRect( p[0].x, p[0].y, p[1].x, p[1].y );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+        canvas.clear();
+        canvas.fillRoundRect( p[0].x, p[0].y, p[1].x, p[1].y, 0 );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+        /* fillRect fills the same pixels as putPixel does */
+        canvas.clear();
+        for (lcdint_t y = min( p[0].y, p[1].y ); y <= max( p[0].y, p[1].y ); y++)
+        {
+            for (lcdint_t x = min( p[0].x, p[1].x ); x <= max( p[0].x, p[1].x ); x++)
+            {
+                canvas.putPixel( x, y );
+            }
+        }
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+    }
+}
+
+TEST(SSD1306, canvas_shapes_test)
+{
+    check_canvas_shapes<1>();
+    check_canvas_shapes<4>();
+    check_canvas_shapes<8>();
+    check_canvas_shapes<16>();
+}
+
+/* Even-odd rule for pixel center, and distance from pixel center to nearest polygon edge */
+static bool polygon_inside(const NanoPoint *p, int count, double x, double y, double &dist)
+{
+    bool inside = false;
+    dist = 1e9;
+    for (int i = 0, j = count - 1; i < count; j = i++)
+    {
+        double x1 = p[j].x, y1 = p[j].y, x2 = p[i].x, y2 = p[i].y;
+        if ( (y1 > y) != (y2 > y) && x < x1 + (y - y1) * (x2 - x1) / (y2 - y1) )
+        {
+            inside = !inside;
+        }
+        double len = (x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1);
+        double t = len ? ((x - x1) * (x2 - x1) + (y - y1) * (y2 - y1)) / len : 0;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        double dx = x1 + t * (x2 - x1) - x, dy = y1 + t * (y2 - y1) - y;
+        dist = dist < dx * dx + dy * dy ? dist : dx * dx + dy * dy;
+    }
+    return inside;
+}
+
+template <uint8_t BPP>
+static void check_canvas_polygons()
+{
+    NanoCanvas<64,40,BPP> canvas;
+    NanoCanvas<64,40,BPP> reference;
+    canvas.setColor( 0xFFFF );
+    reference.setColor( 0xFFFF );
+    /* Concave polygon: notch of U-shape stays empty, its walls and bottom are filled */
+    NanoPoint u[8] = { {10, 5}, {20, 5}, {20, 25}, {40, 25}, {40, 5}, {50, 5}, {50, 35}, {10, 35} };
+    canvas.clear();
+    reference.clear();
+    canvas.fillPolygon( u, 8 );
+    reference.fillRect( 10, 5, 20, 35 );
+    reference.fillRect( 40, 5, 50, 35 );
+    reference.fillRect( 10, 25, 50, 35 );
+    MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+    /* Self-intersecting bowtie: lobes are filled, area between them is not */
+    NanoPoint bowtie[4] = { {10, 5}, {50, 35}, {50, 5}, {10, 35} };
+    canvas.clear();
+    canvas.fillPolygon( bowtie, 4 );
+    CHECK_EQUAL( 0, canvas_pixel<BPP>( canvas, 30, 8 ) );
+    CHECK_EQUAL( 0, canvas_pixel<BPP>( canvas, 30, 32 ) );
+    CHECK( canvas_pixel<BPP>( canvas, 14, 20 ) != 0 );
+    CHECK( canvas_pixel<BPP>( canvas, 46, 20 ) != 0 );
+    /* Pentagram: center is crossed twice by the rays, so even-odd rule leaves it empty */
+    NanoPoint star[5] = { {32, 2}, {43, 35}, {15, 14}, {49, 14}, {21, 35} };
+    canvas.clear();
+    canvas.fillPolygon( star, 5 );
+    CHECK_EQUAL( 0, canvas_pixel<BPP>( canvas, 32, 20 ) );
+    CHECK( canvas_pixel<BPP>( canvas, 32, 8 ) != 0 );
+    CHECK( canvas_pixel<BPP>( canvas, 20, 15 ) != 0 );
+    CHECK( canvas_pixel<BPP>( canvas, 24, 31 ) != 0 );
+    /* Random (mostly concave and self-intersecting) polygons match even-odd rule
+     * everywhere except pixels near edges, which depend on rounding */
+    srand( 6 );
+    for (int i = 0; i < 200; i++)
+    {
+        NanoPoint p[8];
+        int count = 3 + i % 6;
+        for (int n = 0; n < count; n++)
+        {
+            p[n] = { (lcdint_t)(rand() % 80 - 8), (lcdint_t)(rand() % 56 - 8) };
+        }
+        canvas.clear();
+        canvas.fillPolygon( p, count );
+        for (lcdint_t y = 0; y < 40; y++)
+        {
+            for (lcdint_t x = 0; x < 64; x++)
+            {
+                double dist;
+                bool inside = polygon_inside( p, count, x, y, dist );
+                if ( dist > 1.0 )
+                {
+                    CHECK_EQUAL( inside, canvas_pixel<BPP>( canvas, x, y ) != 0 );
+                }
+            }
+        }
+    }
+    /* Edges, longer than 65535 pixels, or clipped far below their top, are not truncated to 16 bits */
+    const NanoPoint far[][3] = { { { 0, 0 }, { 65546, 39 }, { 0, 39 } },
+                                 { { 0, -70000 }, { 63, 39 }, { 0, 39 } },
+                                 { { -70000, -100000 }, { 90000, 100000 }, { -70000, 100000 } } };
+    for (auto &p: far)
+    {
+        canvas.clear();
+        reference.clear();
+        canvas.fillPolygon( p, 3 );
+        reference.fillTriangle( p[0].x, p[0].y, p[1].x, p[1].y, p[2].x, p[2].y );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+        for (lcdint_t y = 0; y < 40; y++)
+        {
+            for (lcdint_t x = 0; x < 64; x++)
+            {
+                double dist;
+                bool inside = polygon_inside( p, 3, x, y, dist );
+                if ( dist > 1.0 )
+                {
+                    CHECK_EQUAL( inside, canvas_pixel<BPP>( canvas, x, y ) != 0 );
+                }
+            }
+        }
+    }
+    /* Rounded rectangle is union of two crossed rectangles and four corner circles */
+    srand( 7 );
+    for (int i = 0; i < 200; i++)
+    {
+        lcdint_t x1 = rand() % 70 - 3, y1 = rand() % 46 - 3;
+        lcdint_t x2 = x1 + rand() % 40, y2 = y1 + rand() % 30;
+        lcdint_t r = rand() % 12 + 1;
+        canvas.clear();
+        reference.clear();
+        canvas.fillRoundRect( x1, y1, x2, y2, r );
+        r = min( r, (lcdint_t)(min( x2 - x1, y2 - y1 ) / 2) );
+        reference.fillRect( x1 + r, y1, x2 - r, y2 );
+        reference.fillRect( x1, y1 + r, x2, y2 - r );
+        reference.fillCircle( x1 + r, y1 + r, r );
+        reference.fillCircle( x2 - r, y1 + r, r );
+        reference.fillCircle( x1 + r, y2 - r, r );
+        reference.fillCircle( x2 - r, y2 - r, r );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+    }
+}
+
+TEST(SSD1306, canvas_polygon_test)
+{
+    check_canvas_polygons<1>();
+    check_canvas_polygons<4>();
+    check_canvas_polygons<8>();
+    check_canvas_polygons<16>();
+}
+
+/* Reference line: each step along major axis rounds minor coordinate to the nearest pixel */
+template <uint8_t BPP>
+static void reference_line(NanoCanvas<64,40,BPP> &canvas, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    int64_t dx = x2 > x1 ? (int64_t)x2 - x1 : (int64_t)x1 - x2;
+    int64_t dy = y2 > y1 ? (int64_t)y2 - y1 : (int64_t)y1 - y2;
+    bool steep = dy > dx;
+    if ( steep ? y1 > y2 : x1 > x2 )
+    {
+        lcdint_t t = x1; x1 = x2; x2 = t;
+        t = y1; y1 = y2; y2 = t;
+    }
+    int64_t len = steep ? dy : dx;
+    int64_t d = steep ? dx : dy;
+    int64_t dir = ( steep ? x2 > x1 : y2 > y1 ) ? 1 : -1;
+    for (int64_t t = 0; t <= len; t++)
+    {
+        lcdint_t m = len ? dir * (d * t + len / 2) / len : 0;
+        if ( steep ) canvas.putPixel( x1 + m, y1 + t );
+        else canvas.putPixel( x1 + t, y1 + m );
+    }
+}
+
+template <uint8_t BPP>
+static void check_canvas_lines()
+{
+    NanoCanvas<64,40,BPP> canvas;
+    NanoCanvas<64,40,BPP> reference;
+    canvas.setColor( 0xFFFF );
+    reference.setColor( 0xFFFF );
+    srand( 7 );
+    for (int i = 0; i < 1000; i++)
+    {
+        /* Lines start and end far outside of canvas to check clipping */
+        lcdint_t x1 = rand() % 200 - 68, y1 = rand() % 160 - 60;
+        lcdint_t x2 = i & 1 ? rand() % 200 - 68 : x1 + y1 - 20;
+        lcdint_t y2 = rand() % 160 - 60;
+        canvas.setOffset( i % 5 - 2, i % 3 - 1 );
+        reference.setOffset( i % 5 - 2, i % 3 - 1 );
+        canvas.clear();
+        reference.clear();
+        canvas.drawLine( x1, y1, x2, y2 );
+        reference_line<BPP>( reference, x1, y1, x2, y2 );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+    }
+    /* Lines, longer than 65535 pixels, are not truncated to 16 bits */
+    const lcdint_t far[][4] = { { -99970, -79980, 100030, 80020 },
+                                { -64968, 100020, 65032, -99980 },
+                                { 5, -80000, 30, 80000 } };
+    canvas.setOffset( 0, 0 );
+    reference.setOffset( 0, 0 );
+    for (auto &line: far)
+    {
+        canvas.clear();
+        reference.clear();
+        canvas.drawLine( line[0], line[1], line[2], line[3] );
+        reference_line<BPP>( reference, line[0], line[1], line[2], line[3] );
+        MEMCMP_EQUAL( reference.getData(), canvas.getData(), 64 * 40 * BPP / 8 );
+    }
+}
+
+TEST(SSD1306, canvas_line_test)
+{
+    check_canvas_lines<1>();
+    check_canvas_lines<4>();
+    check_canvas_lines<8>();
+    check_canvas_lines<16>();
+}
+
+#if !defined(CONFIG_INTERFACE_STATS_DISABLE)
+TEST(SSD1306, bus_timing_test)
+{
+    DisplaySSD1306_128x64_CustomI2C<InterfaceStats<PlatformI2c>> i2c( -1,
+                                    SPlatformI2cConfig{ -1, 0x3C, -1, -1, 100000 } );
+    i2c.begin();
+    i2c.getInterface().resetStats();
+    sdl_core_reset_bus_time();
+    i2c.clear();
+    const SInterfaceStats &i2cStats = i2c.getInterface().getStats();
+    /* 9 bits per byte, start condition with address byte, and stop condition at 100 kHz */
+    CHECK_EQUAL( i2cStats.bytes * 90 + i2cStats.starts * 100 + i2cStats.stops * 10,
+                 sdl_core_get_bus_time_us() );
+    i2c.end();
+
+    DisplaySSD1306_128x64_CustomSPI<InterfaceStats<PlatformSpi>> spi( -1, 1,
+                                    SPlatformSpiConfig{ -1, { 0 }, 1, 1000000, -1, -1 } );
+    spi.begin();
+    spi.getInterface().resetStats();
+    sdl_core_reset_bus_time();
+    spi.clear();
+    uint32_t bytes = spi.getInterface().getStats().bytes;
+    /* 8 bits per byte at 1 MHz */
+    CHECK_EQUAL( bytes * 8, sdl_core_get_bus_time_us() );
+    /* Clear switches to command mode and back to data mode at least once */
+    sdl_core_set_dc_latency( 100000 );
+    sdl_core_reset_bus_time();
+    spi.clear();
+    CHECK( sdl_core_get_bus_time_us() >= bytes * 8 + 2 * 100 );
+    spi.end();
+
+    /* Display without own frequency gets default 8 MHz clock and no D/C latency */
+    DisplaySSD1306_128x64_CustomSPI<InterfaceStats<PlatformSpi>> spi0( -1, 1,
+                                    SPlatformSpiConfig{ -1, { 0 }, 1, 0, -1, -1 } );
+    spi0.begin();
+    spi0.getInterface().resetStats();
+    sdl_core_reset_bus_time();
+    spi0.clear();
+    CHECK_EQUAL( spi0.getInterface().getStats().bytes, sdl_core_get_bus_time_us() );
+    spi0.end();
+}
+#endif
+
+#if defined(__linux__)
+static std::string read_file(const std::string &path)
+{
+    char buf[16] = {0};
+    FILE *f = fopen(path.c_str(), "r");
+    if ( f )
+    {
+        size_t len = fread(buf, 1, sizeof(buf) - 1, f);
+        buf[len] = '\0';
+        fclose(f);
+    }
+    return buf;
+}
+
+static void create_file(const std::string &path)
+{
+    FILE *f = fopen(path.c_str(), "w");
+    if ( f )
+    {
+        fclose(f);
+    }
+}
+
+TEST(SSD1306, linux_gpio_sysfs_test)
+{
+    char tmpl[] = "/tmp/lcdgfx_gpioXXXXXX";
+    std::string root = mkdtemp( tmpl );
+    create_file( root + "/export" );
+    create_file( root + "/unexport" );
+    lcd_linuxSetGpioSysfsPath( root.c_str() );
+
+    CHECK_EQUAL( 0, gpio_export( 17 ) );
+    STRCMP_EQUAL( "17", read_file( root + "/export" ).c_str() );
+    /* Kernel creates pin directory on export */
+    mkdir( (root + "/gpio17").c_str(), 0700 );
+    create_file( root + "/gpio17/direction" );
+    create_file( root + "/gpio17/value" );
+
+    CHECK_EQUAL( 0, gpio_direction( 17, 1 ) );
+    STRCMP_EQUAL( "out", read_file( root + "/gpio17/direction" ).c_str() );
+    CHECK_EQUAL( 0, gpio_write( 17, LCD_HIGH ) );
+    STRCMP_EQUAL( "1", read_file( root + "/gpio17/value" ).c_str() );
+    CHECK_EQUAL( 1, gpio_read( 17 ) );
+    CHECK_EQUAL( 0, gpio_write( 17, LCD_LOW ) );
+    STRCMP_EQUAL( "0", read_file( root + "/gpio17/value" ).c_str() );
+    CHECK_EQUAL( 0, gpio_read( 17 ) );
+
+    CHECK_EQUAL( 0, gpio_unexport( 17 ) );
+    STRCMP_EQUAL( "17", read_file( root + "/unexport" ).c_str() );
+
+    lcd_linuxSetGpioSysfsPath( NULL );
+    unlink( (root + "/gpio17/direction").c_str() );
+    unlink( (root + "/gpio17/value").c_str() );
+    rmdir( (root + "/gpio17").c_str() );
+    unlink( (root + "/export").c_str() );
+    unlink( (root + "/unexport").c_str() );
+    rmdir( root.c_str() );
+}
+#endif
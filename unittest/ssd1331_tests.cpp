@@ -64,8 +64,585 @@ TEST(SSD1331, rgb8_test)
 //    print_screen_content( pixels.data(), sdl_core_get_pixels_len( 8 ), 8, 96 );
 
     CHECK_EQUAL( sizeof(rgb8_test_data), pixels.size() );
-    MEMCMP_EQUAL( rgb8_test_data, pixels.data(), sizeof(rgb8_test_data));
+    CHECK( check_screen_content( rgb8_test_data, 8 ) );
 
     display.end();
 }
 
+TEST(SSD1331, retained_rgb8_test)
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    display.setColor(RGB_COLOR8(255,255,0));
+    display.drawRect(10, 10, 50, 40);
+    display.fillRect(60, 5, 70, 20);
+    display.setFixedFont(ssd1306xled_font6x8);
+    display.printFixed (0, 48, "Retained", STYLE_NORMAL);
+    std::vector<uint8_t> expected( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( expected.data(), 8 );
+
+    display.clear();
+    NanoRetainedDisplay<NanoCanvas<96,64,8>, DisplaySSD1331_96x64x8_SPI> screen( display );
+    screen.setColor(RGB_COLOR8(255,255,0));
+    screen.drawRect(10, 10, 50, 40);
+    screen.fillRect(60, 5, 70, 20);
+    screen.setFixedFont(ssd1306xled_font6x8);
+    screen.printFixed (0, 48, "Retained", STYLE_NORMAL);
+    CHECK( screen.dirtyCount() <= 6 );
+    screen.flush();
+    CHECK_EQUAL( 0, screen.dirtyCount() );
+    CHECK( check_screen_content( expected.data(), 8 ) );
+
+    display.end();
+}
+
+TEST(SSD1331, retained_offset_clip_test)
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    NanoCanvas<96,64,8> reference;
+    reference.setOffset(10, 5);
+    reference.pushClip( { {20, 10}, {80, 50} } );
+    reference.setColor(RGB_COLOR8(255,255,0));
+    reference.fillRect(15, 8, 60, 30);
+    reference.drawLine(12, 60, 100, 20);
+    reference.fillCircle(70, 40, 12);
+    display.drawCanvas(0, 0, reference);
+    std::vector<uint8_t> expected( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( expected.data(), 8 );
+
+    display.setColor(RGB_COLOR8(0,0,255));
+    display.fillRect(0, 0, 95, 63);
+    NanoRetainedDisplay<NanoCanvas<96,64,8>, DisplaySSD1331_96x64x8_SPI> screen( display );
+    /* Full screen area doesn't fit the scratch buffer, so it is sent by strips */
+    screen.clear();
+    screen.flush();
+    screen.setOffset(10, 5);
+    screen.pushClip( { {20, 10}, {80, 50} } );
+    screen.setColor(RGB_COLOR8(255,255,0));
+    screen.fillRect(15, 8, 60, 30);
+    screen.drawLine(12, 60, 100, 20);
+    screen.fillCircle(70, 40, 12);
+    /* Primitive outside of clip area doesn't change anything */
+    screen.fillRect(0, 0, 5, 5);
+    screen.flush();
+    CHECK( check_screen_content( expected.data(), 8 ) );
+
+    display.end();
+}
+
+TEST(SSD1331, screen_diff_test)
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    std::vector<uint8_t> expected( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( expected.data(), 8 );
+    sdl_pixels_diff diff;
+    CHECK_EQUAL( 0, sdl_core_diff_pixels_data( expected.data(), 8, &diff ) );
+    CHECK_EQUAL( 0, diff.areas );
+
+    display.setColor(RGB_COLOR8(255,0,0));
+    display.fillRect(10, 5, 13, 6);
+    display.putPixel(80, 50);
+    CHECK_EQUAL( 9, sdl_core_diff_pixels_data( expected.data(), 8, &diff ) );
+    CHECK_EQUAL( 10, diff.bounds.x1 );
+    CHECK_EQUAL( 5, diff.bounds.y1 );
+    CHECK_EQUAL( 80, diff.bounds.x2 );
+    CHECK_EQUAL( 50, diff.bounds.y2 );
+    CHECK_EQUAL( 2, diff.areas );
+    CHECK_EQUAL( 13, diff.area[0].x2 );
+    CHECK_EQUAL( 6, diff.area[0].y2 );
+    CHECK_EQUAL( 80, diff.area[1].x1 );
+    CHECK_EQUAL( 50, diff.area[1].y1 );
+
+    /* Packed formats are compared pixel by pixel too */
+    std::vector<uint8_t> mono( sdl_core_get_pixels_len( 1 ), 0 );
+    CHECK_EQUAL( 9, sdl_core_diff_pixels_data( mono.data(), 1, &diff ) );
+
+    display.end();
+}
+
+TEST(SSD1331, rgb16_canvas_test)
+{
+    DisplaySSD1331_96x64x16_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    std::vector<uint16_t> pixels( sdl_core_get_pixels_len( 16 ) / 2, 0 );
+
+    NanoCanvas<96,64,8> canvas8;
+    for (int i = 0; i < 96 * 64; i++)
+    {
+        canvas8.getData()[i] = static_cast<uint8_t>( i * 7 );
+    }
+    display.drawCanvas(0, 0, canvas8);
+    sdl_core_get_pixels_data( reinterpret_cast<uint8_t *>(pixels.data()), 16 );
+    for (int i = 0; i < 96 * 64; i++)
+    {
+        CHECK_EQUAL( RGB8_TO_RGB16( canvas8.getData()[i] ), pixels[i] );
+    }
+
+    NanoCanvas<96,64,1> canvas1;
+    canvas1.setColor( 1 );
+    canvas1.drawRect(3, 5, 90, 60);
+    canvas1.fillRect(20, 9, 70, 30);
+    display.setColor( RGB_COLOR16(255, 0, 0) );
+    display.setBackground( RGB_COLOR16(0, 0, 255) );
+    display.drawCanvas(0, 0, canvas1);
+    sdl_core_get_pixels_data( reinterpret_cast<uint8_t *>(pixels.data()), 16 );
+    for (int y = 0; y < 64; y++)
+    {
+        for (int x = 0; x < 96; x++)
+        {
+            bool set = canvas1.getData()[x + (y / 8) * 96] & (1 << (y & 7));
+            CHECK_EQUAL( set ? RGB_COLOR16(255, 0, 0) : RGB_COLOR16(0, 0, 255), pixels[x + y * 96] );
+        }
+    }
+
+    display.end();
+}
+
+TEST(SSD1331, gray4_canvas_test)
+{
+    DisplaySSD1331_96x64x16_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    std::vector<uint16_t> pixels( sdl_core_get_pixels_len( 16 ) / 2, 0 );
+
+    NanoCanvas<96,64,4> canvas4;
+    for (int y = 0; y < 64; y++)
+    {
+        for (int x = 0; x < 96; x++)
+        {
+            canvas4.setColor( (x + y * 3) & 0x0F );
+            canvas4.putPixel( x, y );
+        }
+    }
+    display.drawCanvas(0, 0, canvas4);
+    sdl_core_get_pixels_data( reinterpret_cast<uint8_t *>(pixels.data()), 16 );
+    for (int y = 0; y < 64; y++)
+    {
+        for (int x = 0; x < 96; x++)
+        {
+            /* Gray level is scaled to 8 bits: 0x0 -> 0x00, 0x8 -> 0x88, 0xF -> 0xFF */
+            uint8_t level = ((x + y * 3) & 0x0F) * 0x11;
+            CHECK_EQUAL( RGB_COLOR16(level, level, level), pixels[x + y * 96] );
+        }
+    }
+
+    display.end();
+}
+
+static const uint8_t engine_sprite[8] = { 0xFF, 0x81, 0xBD, 0xA5, 0xA5, 0xBD, 0x81, 0xFF };
+
+#if defined(NE_PARALLEL_RENDER_AVAILABLE)
+
+static std::vector<uint8_t> render_engine(uint8_t threads)
+{
+    typedef NanoEngine<TILE_8x8_RGB8, DisplaySSD1331_96x64x8_SPI> Engine;
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    Engine engine( display );
+    std::vector<NanoFixedSprite<Engine::TilerT>> sprites;
+    for (int i = 0; i < 12; i++)
+    {
+        sprites.push_back( NanoFixedSprite<Engine::TilerT>( { (lcdint_t)(i * 29 % 88), (lcdint_t)(i * 17 % 56) },
+                                                           { 8, 8 }, engine_sprite ) );
+    }
+    for (auto &sprite: sprites)
+    {
+        engine.insert( sprite );
+    }
+    engine.setParallelMode( threads );
+    engine.getCanvas().setColor( RGB_COLOR8(255, 255, 0) );
+    for (int frame = 0; frame < 4; frame++)
+    {
+        for (auto &sprite: sprites)
+        {
+            sprite.moveBy( { 3, 1 } );
+        }
+        engine.display();
+    }
+    for (auto &sprite: sprites)
+    {
+        engine.remove( sprite );
+    }
+    std::vector<uint8_t> pixels( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( pixels.data(), 8 );
+    display.end();
+    return pixels;
+}
+
+TEST(SSD1331, parallel_engine_test)
+{
+    std::vector<uint8_t> expected = render_engine( 0 );
+    std::vector<uint8_t> pixels = render_engine( 3 );
+    CHECK_EQUAL( expected.size(), pixels.size() );
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+}
+#endif
+
+template <class R>
+static std::vector<uint8_t> render_narrow_tiles(uint8_t *scratch = nullptr, uint32_t scratchSize = 0)
+{
+    /* 4-pixel wide tiles give 24 tile columns on 96-pixel wide display */
+    typedef NanoEngine<NanoCanvas<4,8,8>, DisplaySSD1331_96x64x8_SPI, R> Engine;
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    Engine engine( display );
+    NanoFixedSprite<typename Engine::TilerT> left( { 2, 3 }, { 8, 8 }, engine_sprite );
+    NanoFixedSprite<typename Engine::TilerT> right( { 70, 40 }, { 8, 8 }, engine_sprite );
+    engine.insert( left );
+    engine.insert( right );
+    engine.setScratchBuffer( scratch, scratchSize );
+    engine.getCanvas().setColor( RGB_COLOR8(0, 255, 255) );
+    engine.display();
+    left.moveTo( { 5, 20 } );
+    right.moveTo( { 85, 50 } );
+    engine.display();
+    engine.remove( left );
+    engine.remove( right );
+    std::vector<uint8_t> pixels( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( pixels.data(), 8 );
+    display.end();
+    return pixels;
+}
+
+static std::vector<uint8_t> draw_narrow_tiles()
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    display.setColor( RGB_COLOR8(0, 255, 255) );
+    display.drawBitmap1( 5, 20, 8, 8, engine_sprite );
+    display.drawBitmap1( 85, 50, 8, 8, engine_sprite );
+    std::vector<uint8_t> pixels( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( pixels.data(), 8 );
+    display.end();
+    return pixels;
+}
+
+TEST(SSD1331, dirty_region_test)
+{
+    std::vector<uint8_t> expected = draw_narrow_tiles();
+    std::vector<uint8_t> pixels = render_narrow_tiles<NanoDirtyTilesDefault>();
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+    pixels = render_narrow_tiles<NanoDirtyRects<2>>();
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+    /* Bitset smaller than 24x8 tiles falls back to full screen refresh */
+    pixels = render_narrow_tiles<NanoDirtyTiles<16, 4>>();
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+}
+
+TEST(SSD1331, merged_tiles_test)
+{
+    std::vector<uint8_t> expected = draw_narrow_tiles();
+    /* Two full rows of tiles, and the area, smaller than display row */
+    uint8_t scratch[96 * 16];
+    std::vector<uint8_t> pixels = render_narrow_tiles<NanoDirtyTilesDefault>( scratch, sizeof(scratch) );
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+    pixels = render_narrow_tiles<NanoDirtyTilesDefault>( scratch, 4 * 8 * 3 );
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+}
+
+template <class T>
+class ColorBox: public NanoObject<T>
+{
+public:
+    ColorBox(const NanoPoint &pos, const NanoPoint &size, uint8_t color)
+        : NanoObject<T>( pos, size ), m_color( color ) {}
+
+    void draw() override
+    {
+        s_drawCalls++;
+        this->getTiler().getCanvas().setColor( m_color );
+        this->getTiler().getCanvas().fillRect( this->getRect() );
+    }
+
+    static int s_drawCalls;
+
+private:
+    uint8_t m_color;
+};
+
+template <class T>
+int ColorBox<T>::s_drawCalls = 0;
+
+typedef NanoEngine<TILE_8x8_RGB8, DisplaySSD1331_96x64x8_SPI> IndexEngine;
+
+static std::vector<uint8_t> render_boxes(NanoObjectIndex<IndexEngine::TilerT> *index)
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    display.clear();
+    IndexEngine engine( display );
+    std::vector<ColorBox<IndexEngine::TilerT>> boxes;
+    for (int i = 0; i < 16; i++)
+    {
+        boxes.push_back( ColorBox<IndexEngine::TilerT>( { (lcdint_t)(i * 23 % 80), (lcdint_t)(i * 13 % 50) },
+                                                        { 12, 10 }, (uint8_t)(i * 37 + 1) ) );
+    }
+    /* Large box is not put to grid cells, but must be drawn under small ones */
+    ColorBox<IndexEngine::TilerT> background( { 0, 0 }, { 96, 64 }, RGB_COLOR8(0, 0, 128) );
+    for (auto &box: boxes)
+    {
+        engine.insert( box );
+    }
+    engine.insert( background );
+    engine.setObjectIndex( index );
+    ColorBox<IndexEngine::TilerT>::s_drawCalls = 0;
+    for (int frame = 0; frame < 4; frame++)
+    {
+        for (int i = 0; i < 16; i += 3)
+        {
+            boxes[i].moveBy( { 5, 3 } );
+        }
+        boxes[frame].resize( { 20, 6 } );
+        if ( frame == 2 )
+        {
+            engine.remove( boxes[7] );
+        }
+        engine.display();
+    }
+    for (auto &box: boxes)
+    {
+        engine.remove( box );
+    }
+    engine.remove( background );
+    std::vector<uint8_t> pixels( sdl_core_get_pixels_len( 8 ), 0 );
+    sdl_core_get_pixels_data( pixels.data(), 8 );
+    display.end();
+    return pixels;
+}
+
+TEST(SSD1331, object_index_test)
+{
+    std::vector<uint8_t> expected = render_boxes( nullptr );
+    int allCalls = ColorBox<IndexEngine::TilerT>::s_drawCalls;
+    NanoObjectGrid<IndexEngine::TilerT, 16, 128> grid( 3 );
+    std::vector<uint8_t> pixels = render_boxes( &grid );
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+    CHECK( ColorBox<IndexEngine::TilerT>::s_drawCalls * 4 < allCalls );
+    /* Index without enough entries falls back to drawing all objects */
+    NanoObjectGrid<IndexEngine::TilerT, 4, 8> small( 3 );
+    pixels = render_boxes( &small );
+    MEMCMP_EQUAL( expected.data(), pixels.data(), pixels.size() );
+}
+
+TEST(SSD1331, profiler_test)
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    IndexEngine engine( display );
+    NanoEngineProfilerN<2> profiler;
+    engine.setProfiler( &profiler );
+    NanoFixedSprite<IndexEngine::TilerT> sprite( { 4, 4 }, { 8, 8 }, engine_sprite );
+    engine.insert( sprite );
+    engine.display();
+    engine.update();
+    sprite.moveBy( { 8, 0 } );
+    engine.display();
+    engine.display();
+    engine.remove( sprite );
+    display.end();
+    CHECK_EQUAL( 2, profiler.count() );
+    /* 8x8 sprite at (4,4) covers 4 tiles before and after moving by 8 pixels */
+    CHECK_EQUAL( 6, profiler.frame(0).tiles );
+    CHECK_EQUAL( 6 * 64, profiler.frame(0).bytes );
+    CHECK_EQUAL( 0, profiler.frame(1).tiles );
+    CHECK( profiler.frame(0).rasterMaxUs <= profiler.frame(0).rasterUs );
+#if defined(NE_PROFILER_DUMP_AVAILABLE)
+    FILE *file = tmpfile();
+    CHECK_EQUAL( 0, profiler.dumpCsv( file ) );
+    CHECK_EQUAL( 0, profiler.dumpJson( file ) );
+    fclose( file );
+#endif
+}
+
+typedef NanoEngine<TILE_8x8_RGB8, DisplaySSD1331_96x64x8_SPI, NanoDirtyTiles<12, 8>> EdgeEngine;
+static EdgeEngine *s_edgeEngine = nullptr;
+static std::vector<NanoPoint> s_edgeTiles;
+
+static bool record_edge_tile()
+{
+    s_edgeEngine->getCanvas().clear();
+    s_edgeTiles.push_back( s_edgeEngine->getCanvas().offset );
+    return true;
+}
+
+TEST(SSD1331, edge_refresh_test)
+{
+    DisplaySSD1331_96x64x8_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    display.begin();
+    /* 12x8 tiles of 96x64 display use all bits of dirty region */
+    EdgeEngine engine( display );
+    s_edgeEngine = &engine;
+    engine.drawCallback( record_edge_tile );
+    NanoFixedSprite<EdgeEngine::TilerT> sprite( { 90, 20 }, { 8, 8 }, engine_sprite );
+    engine.insert( sprite );
+    engine.display();
+    /* Sprite, crossing the right edge, refreshes only tiles of the last column */
+    s_edgeTiles.clear();
+    sprite.moveTo( { 92, 21 } );
+    engine.display();
+    CHECK_EQUAL( 2, s_edgeTiles.size() );
+    CHECK_EQUAL( 88, s_edgeTiles[0].x );
+    CHECK_EQUAL( 16, s_edgeTiles[0].y );
+    CHECK_EQUAL( 88, s_edgeTiles[1].x );
+    CHECK_EQUAL( 24, s_edgeTiles[1].y );
+    /* Area outside of display is not refreshed at all */
+    s_edgeTiles.clear();
+    sprite.moveTo( { 100, 70 } );
+    engine.display();
+    CHECK_EQUAL( 2, s_edgeTiles.size() );
+    s_edgeTiles.clear();
+    engine.refresh( 96, 0, 200, 10 );
+    engine.refresh( (NanoPoint){ 10, 64 } );
+    engine.display();
+    CHECK_EQUAL( 0, s_edgeTiles.size() );
+    engine.remove( sprite );
+    display.end();
+}
+
+#if !defined(CONFIG_INTERFACE_STATS_DISABLE)
+TEST(SSD1331, interface_stats_test)
+{
+    DisplaySSD1331_96x64x8_CustomSPI<InterfaceStats<PlatformSpi>> display( -1, 1,
+                                     SPlatformSpiConfig{ -1, { 0 }, 1, 0, -1, -1 } );
+    display.begin();
+    display.getInterface().resetStats();
+    display.clear();
+    display.setColor( RGB_COLOR8(255, 255, 0) );
+    display.drawBitmap1( 5, 20, 8, 8, engine_sprite );
+    const SInterfaceStats &stats = display.getInterface().getStats();
+    display.end();
+    CHECK_EQUAL( 2, stats.blocks );
+    CHECK_EQUAL( stats.starts, stats.stops );
+    CHECK( stats.bytes >= 96 * 64 + 8 * 8 );
+    /* Each block switches to command mode and back to data mode, *
+     * display can be already in command mode after begin()       */
+    CHECK( stats.dcToggles >= 2 * stats.blocks - 1 );
+    uint32_t transactions = 0;
+    for (int i = 0; i < LCD_STATS_HISTOGRAM_SIZE; i++)
+    {
+        transactions += stats.transactionUs[i];
+    }
+    CHECK_EQUAL( stats.stops, transactions );
+}
+#endif
+
+/**
+ * Custom bus with basic methods only: 16-bit transfers fall back to send(),
+ * and all data reach the emulator byte by byte, bypassing its bulk path.
+ */
+class ByteSpi
+{
+public:
+    explicit ByteSpi(int8_t dc): m_spi( dc ) {}
+    void begin() { m_spi.begin(); }
+    void end() { m_spi.end(); }
+    void start() { m_spi.start(); }
+    void stop() { m_spi.stop(); }
+    void send(uint8_t data) { m_spi.send( data ); }
+    void sendBuffer(const uint8_t *buffer, uint16_t size)
+    {
+        while (size--)
+        {
+            m_spi.send( *buffer++ );
+        }
+    }
+
+private:
+    SdlSpi m_spi;
+};
+
+template <class D>
+static std::vector<uint8_t> draw_rgb16_primitives(D &display)
+{
+    display.begin();
+    display.clear();
+    display.setColor( RGB_COLOR16(255, 128, 0) );
+    display.fillRect( 10, 5, 60, 40 );
+    display.setColor( RGB_COLOR16(0, 255, 255) );
+    display.drawHLine( 0, 50, 95 );
+    display.drawVLine( 80, 0, 63 );
+    NanoCanvas<16,8,16> canvas;
+    canvas.setColor( RGB_COLOR16(0, 0, 255) );
+    canvas.drawLine( 0, 0, 15, 7 );
+    display.drawCanvas( 30, 20, canvas );
+    std::vector<uint8_t> pixels( sdl_core_get_pixels_len( 16 ), 0 );
+    sdl_core_get_pixels_data( pixels.data(), 16 );
+    display.end();
+    return pixels;
+}
+
+TEST(SSD1331, custom_spi_test)
+{
+    DisplaySSD1331_96x64x16_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+    std::vector<uint8_t> expected = draw_rgb16_primitives( display );
+    DisplaySSD1331_96x64x16_CustomSPI<ByteSpi> custom( -1, 1, 1 );
+    std::vector<uint8_t> pixels = draw_rgb16_primitives( custom );
+    CHECK( expected == pixels );
+}
+
+/* Emulator bulk path must produce the same screen as byte by byte transfer */
+template <class D, class B>
+static void check_bulk_transfer(D &display, B &bytes)
+{
+    std::vector<uint8_t> expected = draw_rgb16_primitives( bytes );
+    std::vector<uint8_t> pixels = draw_rgb16_primitives( display );
+    CHECK_EQUAL( expected.size(), pixels.size() );
+    CHECK( expected == pixels );
+}
+
+TEST(SSD1331, bulk_transfer_test)
+{
+    {
+        DisplayILI9341_240x320x16_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+        DisplayILI9341_240x320x16_CustomSPI<ByteSpi> bytes( -1, 1, 1 );
+        check_bulk_transfer( display, bytes );
+    }
+    {
+        DisplayIL9163_128x128x16_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+        DisplayIL9163_128x128x16_CustomSPI<ByteSpi> bytes( -1, 1, 1 );
+        check_bulk_transfer( display, bytes );
+    }
+    {
+        DisplaySSD1351_128x128x16_SPI display(-1,{-1, 0, 1, 0, -1, -1});
+        DisplaySSD1351_128x128x16_CustomSPI<ByteSpi> bytes( -1, 1, 1 );
+        check_bulk_transfer( display, bytes );
+    }
+}
+
+/** Custom 16-bit display, which records all data sent to it */
+class RecordingDisplay16: public DisplayAny16
+{
+public:
+    RecordingDisplay16(): DisplayAny16( 16, 8 ) {}
+
+    void startBlock(lcduint_t x, lcduint_t y, lcduint_t w) override { data.clear(); }
+
+    void endBlock() override {}
+
+    void send(uint8_t byte) override { data.push_back( byte ); }
+
+    std::vector<uint8_t> data;
+};
+
+TEST(SSD1331, display_any16_test)
+{
+    RecordingDisplay16 display;
+    display.begin();
+    NanoCanvas<16,8,16> canvas;
+    canvas.setColor( RGB_COLOR16(255,128,0) );
+    canvas.fillRect( 2, 1, 12, 6 );
+    canvas.setColor( RGB_COLOR16(0,0,255) );
+    canvas.drawLine( 0, 0, 15, 7 );
+    display.drawCanvas( 0, 0, canvas );
+    CHECK_EQUAL( 16 * 8 * 2, display.data.size() );
+    MEMCMP_EQUAL( canvas.getData(), display.data.data(), 16 * 8 * 2 );
+    display.end();
+}
@@ -23,6 +23,7 @@
 */
 
 #include "utils.h"
+#include "sdl_core.h"
 #include <stdio.h>
 
 // ============================================================================
@@ -115,3 +116,28 @@ void print_screen_content(uint8_t *buffer, int len, uint8_t bpp, int width)
         default: break;
     }
 }
+
+// ============================================================================
+
+bool check_screen_content(const uint8_t *expected, uint8_t bpp)
+{
+    sdl_pixels_diff diff;
+    int count = sdl_core_diff_pixels_data( expected, bpp, &diff );
+    if ( count == 0 )
+    {
+        return true;
+    }
+    if ( count < 0 )
+    {
+        fprintf( stderr, "\nFailed to read screen content\n" );
+        return false;
+    }
+    fprintf( stderr, "\n%d pixels differ in area (%d,%d)-(%d,%d):\n", count,
+             diff.bounds.x1, diff.bounds.y1, diff.bounds.x2, diff.bounds.y2 );
+    for (int i = 0; i < diff.areas; i++)
+    {
+        fprintf( stderr, "    (%d,%d)-(%d,%d)\n", diff.area[i].x1, diff.area[i].y1,
+                 diff.area[i].x2, diff.area[i].y2 );
+    }
+    return false;
+}
@@ -28,3 +28,10 @@
 
 void print_buffer_data(uint8_t *buffer, int len, uint8_t bpp, int width);
 void print_screen_content(uint8_t *buffer, int len, uint8_t bpp, int width);
+
+/**
+ * Compares emulated display content with expected buffer in sdl_core_get_pixels_data()
+ * format. Prints number of different pixels and areas, containing them, to stderr.
+ * Returns true if display content matches expected buffer.
+ */
+bool check_screen_content(const uint8_t *expected, uint8_t bpp);